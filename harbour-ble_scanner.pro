@@ -21,13 +21,33 @@ RCC_DIR=build
 
 DESTDIR = bin
 
-CONFIG += sailfishapp
+CONFIG += sailfishapp c++11
 
 SOURCES += src/ble_scanner.cpp \
     src/device.cpp \
     src/characteristicinfo.cpp \
     src/serviceinfo.cpp \
-    src/deviceinfo.cpp
+    src/deviceinfo.cpp \
+    src/scanscheduler.cpp \
+    src/presencetracker.cpp \
+    src/streamwriter.cpp \
+    src/scanexporter.cpp \
+    src/discoveryworker.cpp \
+    src/devicesearchindex.cpp \
+    src/devicelistmodel.cpp \
+    src/gattsnapshot.cpp \
+    src/sampleseries.cpp \
+    src/signalplot.cpp \
+    src/fleetaudit.cpp \
+    src/memorystats.cpp \
+    src/peripheralemulator.cpp \
+    src/latencyprobe.cpp \
+    src/historystore.cpp \
+    src/hexviewmodel.cpp \
+    src/aes128.cpp \
+    src/irkkeyring.cpp \
+    src/bluezaddresstypes.cpp \
+    src/scanstats.cpp
 
 OTHER_FILES += qml/ble_scanner.qml \
     qml/cover/CoverPage.qml \
@@ -50,7 +70,29 @@ HEADERS += \
     src/device.h \
     src/characteristicinfo.h \
     src/deviceinfo.h \
-    src/serviceinfo.h
+    src/serviceinfo.h \
+    src/scanscheduler.h \
+    src/presencetracker.h \
+    src/streamwriter.h \
+    src/scanexporter.h \
+    src/spscqueue.h \
+    src/discoveryworker.h \
+    src/devicesearchindex.h \
+    src/devicelistmodel.h \
+    src/gattsnapshot.h \
+    src/sampleseries.h \
+    src/signalplot.h \
+    src/fleetaudit.h \
+    src/memorystats.h \
+    src/instancecounter.h \
+    src/peripheralemulator.h \
+    src/latencyprobe.h \
+    src/historystore.h \
+    src/hexviewmodel.h \
+    src/aes128.h \
+    src/irkkeyring.h \
+    src/bluezaddresstypes.h \
+    src/scanstats.h
 
 DISTFILES += \
     qml/pages/DevicesPage.qml \
@@ -60,6 +102,14 @@ DISTFILES += \
     qml/pages/Label.qml \
     qml/pages/Menu.qml \
     qml/pages/Services.qml \
+    qml/pages/GattDiff.qml \
+    qml/pages/Plot.qml \
+    qml/pages/Diagnostics.qml \
+    qml/pages/Peripheral.qml \
+    qml/pages/Latency.qml \
+    qml/pages/History.qml \
+    qml/pages/HexView.qml \
+    qml/pages/Statistics.qml \
     qml/pages/MainPage.qml \
     qml/pages/ApplicationPage.qml \
     rpm/harbour-ble_scanner.changes.in \
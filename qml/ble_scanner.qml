@@ -34,7 +34,11 @@ import "pages"
 
 ApplicationWindow
 {
-    initialPage: Component { MainPage { } }
+    initialPage: Component {
+        Page {
+            MainPage { anchors.fill: parent }
+        }
+    }
     cover: Qt.resolvedUrl("cover/CoverPage.qml")
     allowedOrientations: defaultAllowedOrientations
 }
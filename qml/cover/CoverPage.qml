@@ -32,17 +32,70 @@ import QtQuick 2.0
 import Sailfish.Silica 1.0
 
 CoverBackground {
-    Label {
-        id: label
+    // the aggregated scan statistics are published once a second, the
+    // device list itself is not rendered while in the background
+    property var topVendor: scanStats.vendors.length ? scanStats.vendors[0] : null
+    property var strongest: scanStats.strongest.length ? scanStats.strongest[0] : null
+
+    Column {
         anchors.centerIn: parent
-        text: qsTr("BLE scanner")
+        width: parent.width - 2 * Theme.paddingLarge
+        spacing: Theme.paddingSmall
+
+        Label {
+            id: label
+            width: parent.width
+            horizontalAlignment: Text.AlignHCenter
+            color: Theme.highlightColor
+            text: device.state ? qsTr("Scanning") : qsTr("BLE scanner")
+        }
+
+        Label {
+            width: parent.width
+            horizontalAlignment: Text.AlignHCenter
+            font.pixelSize: Theme.fontSizeSmall
+            text: qsTr("%1 adv/s").arg(scanStats.advertsPerSecond.toFixed(1))
+        }
+
+        Label {
+            width: parent.width
+            horizontalAlignment: Text.AlignHCenter
+            font.pixelSize: Theme.fontSizeSmall
+            text: qsTr("~%1 devices/min").arg(scanStats.uniqueDevices)
+        }
+
+        Label {
+            width: parent.width
+            horizontalAlignment: Text.AlignHCenter
+            font.pixelSize: Theme.fontSizeExtraSmall
+            truncationMode: TruncationMode.Fade
+            visible: topVendor !== null
+            text: topVendor ? topVendor.vendor + ": " + topVendor.count : ""
+        }
+
+        Label {
+            width: parent.width
+            horizontalAlignment: Text.AlignHCenter
+            font.pixelSize: Theme.fontSizeExtraSmall
+            truncationMode: TruncationMode.Fade
+            visible: strongest !== null
+            text: strongest ? (strongest.name.length ? strongest.name : strongest.address)
+                              + " " + strongest.rssi + " dBm" : ""
+        }
     }
 
     CoverActionList {
         id: coverAction
 
         CoverAction {
-            iconSource: "image://theme/icon-cover-refresh"
+            iconSource: device.state ? "image://theme/icon-cover-pause"
+                                     : "image://theme/icon-cover-refresh"
+            onTriggered: {
+                if (device.state)
+                    device.stopDeviceDiscovery()
+                else
+                    device.startDeviceDiscovery()
+            }
         }
     }
 }
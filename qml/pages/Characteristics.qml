@@ -45,6 +45,14 @@ Rectangle {
     width: 300
     height: 600
 
+    Component.onCompleted: {
+        // coming back from the plot page the list is already populated
+        if (characteristicview.count > 0) {
+            info.visible = false
+            menu.menuText = "Back"
+        }
+    }
+
     Header {
         id: header
         anchors.top: parent.top
@@ -87,52 +95,89 @@ Rectangle {
 
         delegate: Rectangle {
             id: characteristicbox
-            height:300
+            height: details.height + 10
             width: parent.width
             color: "lightsteelblue"
             border.width: 2
             border.color: "black"
-            radius: 5
 
-            Label {
-                id: characteristicName
-                textContent: modelData.characteristicName
-                anchors.top: parent.top
-                anchors.topMargin: 5
-            }
+            // plain Text items in a Column instead of individually anchored Labels
+            Column {
+                id: details
+                y: 5
+                width: parent.width
 
-            Label {
-                id: characteristicUuid
-                font.pointSize: characteristicName.font.pointSize*0.7
-                textContent: modelData.characteristicUuid
-                anchors.top: characteristicName.bottom
-                anchors.topMargin: 5
-            }
+                Text {
+                    width: parent.width
+                    font.pointSize: 20
+                    color: "#363636"
+                    horizontalAlignment: Text.AlignHCenter
+                    elide: Text.ElideMiddle
+                    text: modelData.characteristicName
+                }
 
-            Label {
-                id: characteristicValue
-                font.pointSize: characteristicName.font.pointSize*0.7
-                textContent: ("Value: " + modelData.characteristicValue)
-                anchors.bottom: characteristicHandle.top
-                horizontalAlignment: Text.AlignHCenter
-                anchors.topMargin: 5
-            }
+                Text {
+                    width: parent.width
+                    font.pointSize: 14
+                    color: "#363636"
+                    horizontalAlignment: Text.AlignHCenter
+                    elide: Text.ElideMiddle
+                    text: modelData.characteristicUuid + "   Handle: " + modelData.characteristicHandle
+                }
 
-            Label {
-                id: characteristicHandle
-                font.pointSize: characteristicName.font.pointSize*0.7
-                textContent: ("Handlers: " + modelData.characteristicHandle)
-                anchors.bottom: characteristicPermission.top
-                anchors.topMargin: 5
+                Text {
+                    width: parent.width
+                    font.pointSize: 14
+                    color: "#363636"
+                    horizontalAlignment: Text.AlignHCenter
+                    maximumLineCount: 4
+                    wrapMode: Text.WrapAnywhere
+                    elide: Text.ElideRight
+                    text: "Value: " + modelData.characteristicValue
+                }
+
+                Text {
+                    width: parent.width
+                    font.pointSize: 14
+                    color: "#363636"
+                    horizontalAlignment: Text.AlignHCenter
+                    text: modelData.characteristicPermission
+                }
             }
 
-            Label {
-                id: characteristicPermission
-                font.pointSize: characteristicName.font.pointSize*0.7
-                textContent: modelData.characteristicPermission
-                anchors.bottom: parent.bottom
-                anchors.topMargin: 5
-                anchors.bottomMargin: 5
+            // notifying characteristics open a live plot, others and a
+            // double click the hex viewer, a long press the latency probe
+            MouseArea {
+                anchors.fill: parent
+                onClicked: {
+                    if (modelData.characteristicPermission.indexOf("Notify") === -1
+                            && modelData.characteristicPermission.indexOf("Indicate") === -1) {
+                        device.inspectValue(modelData.characteristicUuid)
+                        pageLoader.source = "HexView.qml"
+                        return
+                    }
+                    // opening the plot replaces this delegate, wait until a
+                    // double click can no longer follow
+                    plotTimer.start()
+                }
+                onDoubleClicked: {
+                    plotTimer.stop()
+                    device.inspectValue(modelData.characteristicUuid)
+                    pageLoader.source = "HexView.qml"
+                }
+                onPressAndHold: {
+                    latency.characteristic = modelData.characteristicUuid
+                    pageLoader.source = "Latency.qml"
+                }
+
+                Timer {
+                    id: plotTimer
+                    interval: Qt.styleHints.mouseDoubleClickInterval
+                    onTriggered: {
+                        device.startPlot(modelData.characteristicUuid)
+                        pageLoader.source = "Plot.qml"
+                    }
+                }
             }
         }
     }
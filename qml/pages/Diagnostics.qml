@@ -0,0 +1,165 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+
+Rectangle {
+    width: 300
+    height: 600
+
+    Component.onCompleted: memoryStats.active = true
+    Component.onDestruction: memoryStats.active = false
+
+    function kilobytes(bytes) {
+        return (bytes / 1024).toFixed(1) + " kB"
+    }
+
+    Header {
+        id: header
+        anchors.top: parent.top
+        headerText: "Diagnostics"
+    }
+
+    Column {
+        id: totals
+        anchors.top: header.bottom
+        width: parent.width
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "Characteristic values: " + kilobytes(memoryStats.characteristicBytes)
+                  + " (peak " + kilobytes(memoryStats.peakCharacteristicBytes) + ")"
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "History buffers: " + kilobytes(memoryStats.historyBytes)
+                  + " (peak " + kilobytes(memoryStats.peakHistoryBytes) + ")"
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            visible: memoryStats.residentKb >= 0
+            text: "Resident: " + memoryStats.residentKb + " kB (peak "
+                  + memoryStats.peakResidentKb + " kB)"
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: memoryStats.droppedRecords > 0 ? "#c62828" : "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "Dropped advertisements: " + memoryStats.droppedRecords
+        }
+    }
+
+    ListView {
+        id: counterview
+        width: parent.width
+        clip: true
+
+        anchors.top: totals.bottom
+        anchors.bottom: keyringMenu.top
+        model: memoryStats.counters
+
+        delegate: Rectangle {
+            height: entry.height + 10
+            width: parent.width
+            // live objects which are not in any list are probably leaked
+            color: modelData.listed >= 0 && modelData.live > modelData.listed
+                   ? "#ffcdd2" : "lightsteelblue"
+            border.width: 1
+            border.color: "black"
+
+            Column {
+                id: entry
+                y: 5
+                width: parent.width
+
+                Text {
+                    width: parent.width
+                    font.pointSize: 16
+                    color: "#363636"
+                    horizontalAlignment: Text.AlignHCenter
+                    text: modelData.name
+                }
+
+                Text {
+                    width: parent.width
+                    font.pointSize: 12
+                    color: "#363636"
+                    horizontalAlignment: Text.AlignHCenter
+                    text: "live " + modelData.live + "   peak " + modelData.peak
+                          + (modelData.created >= 0 ? "   created " + modelData.created : "")
+                          + (modelData.listed >= 0 ? "   listed " + modelData.listed : "")
+                }
+            }
+        }
+    }
+
+    // resolvable private addresses are merged under the identities of
+    // the imported keys
+    Menu {
+        id: keyringMenu
+        anchors.bottom: menu.top
+        menuWidth: parent.width
+        menuText: "Import IRKs from Documents/ble_scanner-irks.txt\n"
+                  + keyring.count + " keys loaded, AES: " + keyring.implementation
+        onButtonClick: device.update = keyring.importFile()
+    }
+
+    Menu {
+        id: menu
+        anchors.bottom: parent.bottom
+        menuWidth: parent.width
+        menuText: "Back"
+        menuHeight: (parent.height/6)
+        onButtonClick: {
+            memoryStats.report()
+            pageLoader.source = "main.qml"
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+
+Rectangle {
+    width: 300
+    height: 600
+
+    Header {
+        id: header
+        anchors.top: parent.top
+        headerText: "Value (" + device.valueModel.size + " bytes)"
+    }
+
+    Connections {
+        target: device
+        onDisconnected: {
+            pageLoader.source = "main.qml"
+        }
+    }
+
+    // rows are formatted by the model as the view asks for them
+    ListView {
+        id: hexview
+        width: parent.width
+        clip: true
+
+        anchors.top: header.bottom
+        anchors.bottom: widthMenu.top
+        model: device.valueModel
+
+        delegate: Row {
+            spacing: 10
+            x: 5
+
+            Text {
+                font.family: "monospace"
+                font.pointSize: 12
+                color: "#808080"
+                text: offset
+            }
+
+            Text {
+                font.family: "monospace"
+                font.pointSize: 12
+                color: "#363636"
+                text: hex
+            }
+
+            Text {
+                font.family: "monospace"
+                font.pointSize: 12
+                color: "#363636"
+                text: ascii
+            }
+        }
+    }
+
+    Menu {
+        id: widthMenu
+        anchors.bottom: menu.top
+        menuWidth: parent.width
+        menuText: device.valueModel.bytesPerRow + " bytes per row"
+        onButtonClick: device.valueModel.bytesPerRow = device.valueModel.bytesPerRow === 16 ? 8 : 16
+    }
+
+    Menu {
+        id: menu
+        anchors.bottom: parent.bottom
+        menuWidth: parent.width
+        menuText: "Back"
+        menuHeight: (parent.height/6)
+        onButtonClick: pageLoader.source = "Characteristics.qml"
+    }
+}
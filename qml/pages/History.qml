@@ -0,0 +1,140 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+
+Rectangle {
+    width: 300
+    height: 600
+
+    property var rangeNames: ["Last hour", "Last 24 hours", "Last 7 days", "Last 30 days"]
+    property var rangeLengths: [3600000, 86400000, 7 * 86400000, 30 * 86400000]
+    property int range: 1
+    property var seen: []
+    // hourly mean RSSI of every seen device over the selected range
+    property var histories: ({})
+
+    function refresh() {
+        var now = new Date()
+        var from = new Date(now.getTime() - rangeLengths[range])
+        seen = history.devicesSeenBetween(from, now)
+        histories = history.rssiHistories(seen, from, now, 2)
+    }
+
+    Component.onCompleted: refresh()
+
+    Header {
+        id: header
+        anchors.top: parent.top
+        headerText: "History"
+    }
+
+    Text {
+        id: summary
+        anchors.top: header.bottom
+        width: parent.width
+        horizontalAlignment: Text.AlignHCenter
+        font.pointSize: 14
+        color: "#363636"
+        text: seen.length + " devices seen, store uses "
+              + (history.diskUsage / 1024).toFixed(0) + " kB"
+    }
+
+    ListView {
+        id: historyview
+        width: parent.width
+        clip: true
+
+        anchors.top: summary.bottom
+        anchors.bottom: rangeMenu.top
+        model: seen
+
+        delegate: Rectangle {
+            height: entry.height + 10
+            width: parent.width
+            color: "lightsteelblue"
+            border.width: 1
+            border.color: "black"
+
+            property var points: histories[modelData] || []
+
+            Column {
+                id: entry
+                y: 5
+                width: parent.width
+
+                Text {
+                    width: parent.width
+                    font.pointSize: 16
+                    color: "#363636"
+                    horizontalAlignment: Text.AlignHCenter
+                    text: modelData
+                }
+
+                Text {
+                    width: parent.width
+                    font.pointSize: 12
+                    color: "#363636"
+                    horizontalAlignment: Text.AlignHCenter
+                    elide: Text.ElideLeft
+                    visible: points.length > 0
+                    text: points.map(function(p) { return p.mean }).join(" ")
+                }
+            }
+        }
+    }
+
+    Menu {
+        id: rangeMenu
+        anchors.bottom: menu.top
+        menuWidth: parent.width
+        menuText: "Range: " + rangeNames[range]
+        onButtonClick: {
+            range = (range + 1) % rangeNames.length
+            refresh()
+        }
+    }
+
+    Menu {
+        id: menu
+        anchors.bottom: parent.bottom
+        menuWidth: parent.width
+        menuText: "Back"
+        menuHeight: (parent.height/6)
+        onButtonClick: pageLoader.source = "main.qml"
+    }
+}
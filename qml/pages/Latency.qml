@@ -0,0 +1,162 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+
+Rectangle {
+    width: 300
+    height: 600
+
+    property var modeNames: ["Read", "Write + notify"]
+    property var intervals: [0, 20, 100, 500, 1000]
+
+    Component.onDestruction: latency.stop()
+
+    function ms(value) {
+        return value.toFixed(2) + " ms"
+    }
+
+    Header {
+        id: header
+        anchors.top: parent.top
+        headerText: "Latency probe"
+    }
+
+    Column {
+        id: stats
+        anchors.top: header.bottom
+        width: parent.width
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            elide: Text.ElideMiddle
+            text: latency.characteristic
+        }
+
+        Text {
+            id: status
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            visible: text.length > 0
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: latency.count + " samples, " + latency.lost + " lost"
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 20
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "Median " + ms(latency.median)
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "Min " + ms(latency.minimum) + "   p99 " + ms(latency.p99)
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "Jitter " + ms(latency.jitter) + "   Last " + ms(latency.last)
+        }
+    }
+
+    Connections {
+        target: device
+        onDisconnected: {
+            pageLoader.source = "main.qml"
+        }
+    }
+
+    Menu {
+        id: modeMenu
+        anchors.bottom: intervalMenu.top
+        menuWidth: parent.width
+        menuText: "Round trip: " + modeNames[latency.mode]
+        onButtonClick: latency.mode = (latency.mode + 1) % modeNames.length
+    }
+
+    Menu {
+        id: intervalMenu
+        anchors.bottom: startMenu.top
+        menuWidth: parent.width
+        menuText: "Pause between probes: " + latency.interval + " ms"
+        onButtonClick: latency.interval = intervals[(intervals.indexOf(latency.interval) + 1) % intervals.length]
+    }
+
+    Menu {
+        id: startMenu
+        anchors.bottom: menu.top
+        menuWidth: parent.width
+        menuText: latency.running ? "Stop" : "Start"
+        onButtonClick: {
+            if (latency.running)
+                latency.stop()
+            else
+                status.text = latency.start()
+        }
+    }
+
+    Menu {
+        id: menu
+        anchors.bottom: parent.bottom
+        menuWidth: parent.width
+        menuText: "Back"
+        menuHeight: (parent.height/6)
+        onButtonClick: {
+            latency.stop()
+            pageLoader.source = "Characteristics.qml"
+        }
+    }
+}
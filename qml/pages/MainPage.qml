@@ -63,14 +63,87 @@ Rectangle {
         visible: false
     }
 
+    Rectangle {
+        id: searchBox
+        anchors.top: header.bottom
+        width: parent.width
+        height: 60
+        border.width: 1
+        border.color: "#363636"
+        radius: 5
+
+        TextInput {
+            id: searchInput
+            anchors.fill: parent
+            anchors.margins: 10
+            verticalAlignment: TextInput.AlignVCenter
+            font.pointSize: 16
+            color: "#363636"
+            inputMethodHints: Qt.ImhNoAutoUppercase | Qt.ImhNoPredictiveText
+            onTextChanged: device.searchQuery = text
+        }
+
+        Text {
+            anchors.fill: searchInput
+            verticalAlignment: Text.AlignVCenter
+            font.pointSize: 16
+            color: "#9a9a9a"
+            text: "Search name, address or service UUID"
+            visible: !searchInput.text && !searchInput.activeFocus
+        }
+    }
+
+    Item {
+        id: sortBar
+        anchors.top: searchBox.bottom
+        width: parent.width
+        height: sortToggle.height
+
+        property var sortNames: ["RSSI", "Name", "Last seen", "Vendor"]
+        property var groupNames: ["None", "Manufacturer", "Service"]
+
+        Menu {
+            id: sortToggle
+            anchors.left: parent.left
+            menuWidth: parent.width / 2
+            menuText: "Sort: " + sortBar.sortNames[device.deviceModel.sortMode]
+            onButtonClick: device.deviceModel.sortMode = (device.deviceModel.sortMode + 1) % sortBar.sortNames.length
+        }
+
+        Menu {
+            anchors.right: parent.right
+            menuWidth: parent.width / 2
+            menuText: "Group: " + sortBar.groupNames[device.deviceModel.groupMode]
+            onButtonClick: device.deviceModel.groupMode = (device.deviceModel.groupMode + 1) % sortBar.groupNames.length
+        }
+    }
+
     ListView {
         id: theListView
         width: parent.width
         clip: true
 
-        anchors.top: header.bottom
-        anchors.bottom: connectToggle.top
-        model: device.devicesList
+        anchors.top: sortBar.bottom
+        anchors.bottom: toolsBar.top
+        // search results are a plain object list, the full list is the
+        // sorted model; the delegate reads the same names from both
+        model: device.searchQuery.length ? device.searchResults : device.deviceModel
+
+        section.property: device.deviceModel.groupMode !== 0 && !device.searchQuery.length ? "section" : ""
+        section.delegate: Rectangle {
+            width: parent.width
+            height: 40
+            color: "#363636"
+
+            Text {
+                anchors.fill: parent
+                anchors.leftMargin: 10
+                verticalAlignment: Text.AlignVCenter
+                color: "#E3E3E3"
+                font.pointSize: 14
+                text: section
+            }
+        }
 
         delegate: Rectangle {
             id: box
@@ -89,28 +162,149 @@ Rectangle {
             MouseArea {
                 anchors.fill: parent
                 onClicked: {
-                    device.scanServices(modelData.deviceAddress);
+                    device.scanServices(deviceAddress);
                     pageLoader.source = "Services.qml"
                 }
             }
 
             Label {
-                id: deviceName
-                textContent: modelData.deviceName
+                id: nameLabel
+                textContent: deviceName
                 anchors.top: parent.top
                 anchors.topMargin: 5
             }
 
             Label {
-                id: deviceAddress
-                textContent: modelData.deviceAddress
-                font.pointSize: deviceName.font.pointSize*0.7
+                id: addressLabel
+                textContent: adapterRssi.length ? deviceAddress + " (" + adapterRssi + ")"
+                                                : deviceAddress
+                font.pointSize: nameLabel.font.pointSize*0.7
                 anchors.bottom: box.bottom
                 anchors.bottomMargin: 5
             }
         }
     }
 
+    Item {
+        id: toolsBar
+        anchors.bottom: auditMenu.top
+        width: parent.width
+        height: diagnosticsMenu.height
+
+        Menu {
+            id: diagnosticsMenu
+            anchors.left: parent.left
+            menuWidth: parent.width / 4
+            menuText: "Diagnostics"
+            onButtonClick: pageLoader.source = "Diagnostics.qml"
+        }
+
+        Menu {
+            id: peripheralMenu
+            anchors.left: diagnosticsMenu.right
+            menuWidth: parent.width / 4
+            menuText: peripheral.running ? "Peripheral: On" : "Peripheral"
+            onButtonClick: pageLoader.source = "Peripheral.qml"
+        }
+
+        Menu {
+            anchors.left: peripheralMenu.right
+            menuWidth: parent.width / 4
+            menuText: "History"
+            onButtonClick: pageLoader.source = "History.qml"
+        }
+
+        Menu {
+            anchors.right: parent.right
+            menuWidth: parent.width / 4
+            menuText: "Statistics"
+            onButtonClick: pageLoader.source = "Statistics.qml"
+        }
+    }
+
+    Menu {
+        id: auditMenu
+
+        menuWidth: parent.width
+        anchors.bottom: exportMenu.top
+        visible: device.devicesList.length > 0 || audit.running
+        menuText: {
+            if (audit.running)
+                return "Auditing " + audit.completed + "/" + audit.total
+                        + " (" + audit.failed + " failed)\nTap to cancel"
+            if (device.searchQuery.length)
+                return "Audit devices matching \"" + device.searchQuery + "\""
+            return "Audit all devices"
+        }
+
+        onButtonClick: {
+            if (audit.running)
+                audit.cancel()
+            else
+                device.update = audit.start(device.searchQuery)
+        }
+
+        Connections {
+            target: audit
+            onFinished: device.update = report
+        }
+    }
+
+    Menu {
+        id: exportMenu
+
+        menuWidth: parent.width
+        anchors.bottom: schedulerToggle.top
+        visible: device.devicesList.length > 0
+        menuText: "Export devices (CSV + JSON)"
+
+        onButtonClick: {
+            exporter.exportDevices("csv")
+            exporter.exportPresence("csv")
+            device.update = exporter.exportDevices("json")
+        }
+    }
+
+    Menu {
+        id: schedulerToggle
+
+        menuWidth: parent.width
+        anchors.bottom: adapterToggle.top
+        menuText: {
+            if (!scheduler.enabled)
+                return "Periodic scan: Off"
+            return "Periodic scan: " + (scheduler.currentWindow / 1000).toFixed(1) + "s every "
+                    + (scheduler.scanInterval / 1000) + "s\n"
+                    + "~" + scheduler.batteryPerHour.toFixed(1) + " mAh/h, "
+                    + scheduler.cpuPerHour.toFixed(1) + " CPU s/h"
+        }
+
+        onButtonClick: scheduler.enabled = !scheduler.enabled;
+    }
+
+    Menu {
+        id: adapterToggle
+
+        property var choices: device.adapters.length > 1 ? [""].concat(device.adapters).concat(["all"]) : [""]
+
+        menuWidth: parent.width
+        anchors.bottom: connectToggle.top
+        visible: choices.length > 1
+        menuText: {
+            if (device.adapter === "")
+                "Adapter: default"
+            else if (device.adapter === "all")
+                "Adapter: all (" + device.adapters.length + ")"
+            else
+                "Adapter: " + device.adapter
+        }
+
+        onButtonClick: {
+            var next = (choices.indexOf(device.adapter) + 1) % choices.length
+            device.adapter = choices[next]
+        }
+    }
+
     Menu {
         id: connectToggle
 
@@ -121,9 +315,9 @@ Rectangle {
                     else
                         visible = false
                     if (device.useRandomAddress)
-                        "Address type: Random"
+                        "Default address type: Random"
                     else
-                        "Address type: Public"
+                        "Default address type: Public"
         }
 
         onButtonClick: device.useRandomAddress = !device.useRandomAddress;
@@ -148,5 +342,11 @@ Rectangle {
     Loader {
         id: pageLoader
         anchors.fill: parent
+        // build pages off the GUI thread, the current page stays up meanwhile
+        asynchronous: true
+
+        property double switchStart: 0
+        onSourceChanged: switchStart = Date.now()
+        onLoaded: console.info("Page " + source + " ready after " + (Date.now() - switchStart) + " ms")
     }
 }
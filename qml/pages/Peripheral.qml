@@ -0,0 +1,153 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+
+Rectangle {
+    width: 300
+    height: 600
+
+    property var rates: [1, 10, 50, 100, 200, 500]
+    property var payloads: [8, 20, 100, 244, 512]
+
+    function next(list, value) {
+        return list[(list.indexOf(value) + 1) % list.length]
+    }
+
+    Header {
+        id: header
+        anchors.top: parent.top
+        headerText: "Peripheral mode"
+    }
+
+    Column {
+        id: stats
+        anchors.top: header.bottom
+        width: parent.width
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            wrapMode: Text.Wrap
+            text: {
+                if (!peripheral.supported)
+                    return "Peripheral mode needs Qt 5.7 or later"
+                if (!peripheral.running)
+                    return "Stopped"
+                if (!peripheral.centralConnected)
+                    return "Advertising as \"" + peripheral.localName + "\""
+                return "Central connected"
+            }
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            visible: peripheral.running
+            text: "Sent " + peripheral.notificationsSent + " notifications, "
+                  + (peripheral.sendRate / 1024).toFixed(1) + " kB/s"
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            visible: peripheral.running
+            text: "Received " + peripheral.writesReceived + " writes, "
+                  + (peripheral.receiveRate / 1024).toFixed(1) + " kB/s"
+        }
+    }
+
+    Menu {
+        id: rateMenu
+        anchors.bottom: payloadMenu.top
+        menuWidth: parent.width
+        menuText: "Notification rate: " + peripheral.notifyRate + " /s"
+        onButtonClick: peripheral.notifyRate = next(rates, peripheral.notifyRate)
+    }
+
+    Menu {
+        id: payloadMenu
+        anchors.bottom: snapshotMenu.top
+        menuWidth: parent.width
+        menuText: "Payload size: " + peripheral.payloadSize + " bytes"
+        onButtonClick: peripheral.payloadSize = next(payloads, peripheral.payloadSize)
+    }
+
+    Menu {
+        id: snapshotMenu
+        anchors.bottom: startMenu.top
+        menuWidth: parent.width
+        visible: peripheral.supported && !peripheral.running
+        menuText: "Serve the latest GATT snapshot"
+        onButtonClick: {
+            var saved = snapshots.savedSnapshots()
+            if (saved.length === 0)
+                device.update = "No saved snapshot"
+            else
+                device.update = peripheral.startFromSnapshot(saved[0])
+        }
+    }
+
+    Menu {
+        id: startMenu
+        anchors.bottom: menu.top
+        menuWidth: parent.width
+        visible: peripheral.supported
+        menuText: peripheral.running ? "Stop" : "Start test server"
+        onButtonClick: {
+            if (peripheral.running)
+                peripheral.stop()
+            else
+                device.update = peripheral.startTestServer()
+        }
+    }
+
+    Menu {
+        id: menu
+        anchors.bottom: parent.bottom
+        menuWidth: parent.width
+        menuText: "Back"
+        menuHeight: (parent.height/6)
+        onButtonClick: pageLoader.source = "main.qml"
+    }
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import harbour.ble_scanner 1.0
+
+Rectangle {
+    width: 300
+    height: 600
+
+    property var formats: ["uint8", "int8", "uint16", "int16", "uint32", "int32", "float"]
+
+    Header {
+        id: header
+        anchors.top: parent.top
+        headerText: "Notification plot"
+    }
+
+    Text {
+        id: stats
+        anchors.top: header.bottom
+        width: parent.width
+        horizontalAlignment: Text.AlignHCenter
+        font.pointSize: 14
+        color: "#363636"
+        text: "Last: " + device.plotSeries.last
+              + "   Min: " + plot.minimum + "   Max: " + plot.maximum
+              + "   Samples: " + device.plotSeries.count
+    }
+
+    SignalPlot {
+        id: plot
+        anchors.top: stats.bottom
+        anchors.bottom: formatMenu.top
+        anchors.margins: 10
+        width: parent.width
+        color: "#363636"
+        series: device.plotSeries
+    }
+
+    Connections {
+        target: device
+        onDisconnected: {
+            pageLoader.source = "main.qml"
+        }
+    }
+
+    Menu {
+        id: formatMenu
+        anchors.bottom: menu.top
+        menuWidth: parent.width
+        menuText: "Format: " + device.plotFormat
+        menuHeight: (parent.height/6)
+        onButtonClick: {
+            var next = (formats.indexOf(device.plotFormat) + 1) % formats.length
+            device.plotFormat = formats[next]
+        }
+    }
+
+    Menu {
+        id: menu
+        anchors.bottom: parent.bottom
+        menuWidth: parent.width
+        menuText: "Back"
+        menuHeight: (parent.height/6)
+        onButtonClick: {
+            device.stopPlot()
+            pageLoader.source = "Characteristics.qml"
+        }
+    }
+}
@@ -86,7 +86,7 @@ Rectangle {
         id: servicesview
         width: parent.width
         anchors.top: header.bottom
-        anchors.bottom: menu.top
+        anchors.bottom: snapshotBar.top
         model: device.servicesList
         clip: true
 
@@ -133,6 +133,47 @@ Rectangle {
         }
     }
 
+    Item {
+        id: snapshotBar
+        anchors.bottom: exportMenu.top
+        width: parent.width
+        height: saveSnapshot.height
+        visible: servicesview.count > 0
+
+        Menu {
+            id: saveSnapshot
+            anchors.left: parent.left
+            menuWidth: parent.width / 2
+            menuText: "Save GATT snapshot"
+            onButtonClick: device.update = "Back\n(" + snapshots.saveLive() + ")"
+        }
+
+        Menu {
+            anchors.right: parent.right
+            menuWidth: parent.width / 2
+            menuText: "Compare with snapshot"
+            onButtonClick: {
+                var message = snapshots.compareLiveWithLatest()
+                device.update = "Back\n(" + message + ")"
+                // on success the message is the diff summary
+                if (message === snapshots.summary)
+                    pageLoader.source = "GattDiff.qml"
+            }
+        }
+    }
+
+    Menu {
+        id: exportMenu
+        anchors.bottom: menu.top
+        menuWidth: parent.width
+        visible: servicesview.count > 0
+        menuText: "Export GATT tree (CSV + JSON)"
+        onButtonClick: {
+            exporter.exportGattTree("csv")
+            device.update = "Back\n(" + exporter.exportGattTree("json") + ")"
+        }
+    }
+
     Menu {
         id: menu
         anchors.bottom: parent.bottom
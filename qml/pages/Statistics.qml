@@ -0,0 +1,138 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+
+Rectangle {
+    width: 300
+    height: 600
+
+    Header {
+        id: header
+        anchors.top: parent.top
+        headerText: "Scan statistics"
+    }
+
+    Column {
+        id: totals
+        anchors.top: header.bottom
+        width: parent.width
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: scanStats.advertsPerSecond.toFixed(1) + " advertisements/s"
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "Last " + scanStats.windowSeconds + " s: " + scanStats.advertsInWindow
+                  + " advertisements, ~" + scanStats.uniqueDevices + " devices"
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "Top vendors"
+        }
+
+        Repeater {
+            model: scanStats.vendors
+
+            Text {
+                width: parent.width
+                font.pointSize: 12
+                color: "#363636"
+                horizontalAlignment: Text.AlignHCenter
+                text: modelData.vendor + ": " + modelData.count
+            }
+        }
+
+        Text {
+            width: parent.width
+            font.pointSize: 14
+            color: "#363636"
+            horizontalAlignment: Text.AlignHCenter
+            text: "Strongest devices"
+        }
+    }
+
+    ListView {
+        id: strongestview
+        width: parent.width
+        clip: true
+
+        anchors.top: totals.bottom
+        anchors.bottom: menu.top
+        model: scanStats.strongest
+
+        delegate: Rectangle {
+            height: 80
+            width: parent.width
+            color: "lightsteelblue"
+            border.width: 1
+            border.color: "black"
+
+            Text {
+                anchors.fill: parent
+                font.pointSize: 14
+                color: "#363636"
+                horizontalAlignment: Text.AlignHCenter
+                verticalAlignment: Text.AlignVCenter
+                elide: Text.ElideRight
+                text: (modelData.name.length ? modelData.name : modelData.address)
+                      + "\n" + modelData.rssi + " dBm"
+            }
+        }
+    }
+
+    Menu {
+        id: menu
+        anchors.bottom: parent.bottom
+        menuWidth: parent.width
+        menuText: "Back"
+        menuHeight: (parent.height/6)
+        onButtonClick: pageLoader.source = "main.qml"
+    }
+}
@@ -0,0 +1,283 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "aes128.h"
+#include <string.h>
+
+// The hardware paths are compiled with per function target attributes
+// and picked at run time, so one binary runs everywhere. Older compilers
+// can't use the intrinsics that way and only get the portable code.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define AES128_AESNI
+#include <cpuid.h>
+#include <wmmintrin.h>
+#elif defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 6 \
+    && defined(__aarch64__) && defined(__linux__)
+#define AES128_ARMV8
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace {
+
+const uint8_t sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+const uint8_t rcon[10] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
+
+inline uint8_t xtime(uint8_t x)
+{
+    return uint8_t((x << 1) ^ ((x >> 7) * 0x1b));
+}
+
+void expandKey(const uint8_t key[16], uint8_t roundKeys[176])
+{
+    memcpy(roundKeys, key, 16);
+    for (int i = 16, round = 0; i < 176; i += 4) {
+        uint8_t word[4] = { roundKeys[i - 4], roundKeys[i - 3], roundKeys[i - 2], roundKeys[i - 1] };
+        if (i % 16 == 0) {
+            // RotWord, SubWord and the round constant
+            const uint8_t first = word[0];
+            word[0] = uint8_t(sbox[word[1]] ^ rcon[round++]);
+            word[1] = sbox[word[2]];
+            word[2] = sbox[word[3]];
+            word[3] = sbox[first];
+        }
+        for (int j = 0; j < 4; ++j)
+            roundKeys[i + j] = uint8_t(roundKeys[i - 16 + j] ^ word[j]);
+    }
+}
+
+void encryptPortable(const uint8_t roundKeys[176], const uint8_t in[16], uint8_t out[16])
+{
+    // the state is column major, byte r + 4c is row r of column c
+    uint8_t s[16];
+    for (int i = 0; i < 16; ++i)
+        s[i] = uint8_t(in[i] ^ roundKeys[i]);
+
+    for (int round = 1; round <= 10; ++round) {
+        // SubBytes and ShiftRows in one go
+        uint8_t t[16];
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r)
+                t[r + 4 * c] = sbox[s[r + 4 * ((c + r) & 3)]];
+        }
+
+        if (round < 10) {
+            for (int c = 0; c < 4; ++c) {
+                uint8_t *col = t + 4 * c;
+                const uint8_t all = uint8_t(col[0] ^ col[1] ^ col[2] ^ col[3]);
+                const uint8_t first = col[0];
+                col[0] ^= uint8_t(all ^ xtime(uint8_t(col[0] ^ col[1])));
+                col[1] ^= uint8_t(all ^ xtime(uint8_t(col[1] ^ col[2])));
+                col[2] ^= uint8_t(all ^ xtime(uint8_t(col[2] ^ col[3])));
+                col[3] ^= uint8_t(all ^ xtime(uint8_t(col[3] ^ first)));
+            }
+        }
+
+        const uint8_t *key = roundKeys + 16 * round;
+        for (int i = 0; i < 16; ++i)
+            s[i] = uint8_t(t[i] ^ key[i]);
+    }
+    memcpy(out, s, 16);
+}
+
+#if defined(AES128_AESNI)
+
+__attribute__((target("aes,sse2")))
+void encryptAesNi(const uint8_t roundKeys[176], const uint8_t *in, uint8_t *out, size_t count)
+{
+    __m128i keys[11];
+    for (int i = 0; i < 11; ++i)
+        keys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(roundKeys + 16 * i));
+
+    // four independent blocks hide the latency of aesenc
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i *src = reinterpret_cast<const __m128i *>(in + 16 * i);
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128(src), keys[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + 1), keys[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + 2), keys[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + 3), keys[0]);
+        for (int round = 1; round < 10; ++round) {
+            b0 = _mm_aesenc_si128(b0, keys[round]);
+            b1 = _mm_aesenc_si128(b1, keys[round]);
+            b2 = _mm_aesenc_si128(b2, keys[round]);
+            b3 = _mm_aesenc_si128(b3, keys[round]);
+        }
+        __m128i *dst = reinterpret_cast<__m128i *>(out + 16 * i);
+        _mm_storeu_si128(dst, _mm_aesenclast_si128(b0, keys[10]));
+        _mm_storeu_si128(dst + 1, _mm_aesenclast_si128(b1, keys[10]));
+        _mm_storeu_si128(dst + 2, _mm_aesenclast_si128(b2, keys[10]));
+        _mm_storeu_si128(dst + 3, _mm_aesenclast_si128(b3, keys[10]));
+    }
+    for (; i < count; ++i) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * i)),
+                                  keys[0]);
+        for (int round = 1; round < 10; ++round)
+            b = _mm_aesenc_si128(b, keys[round]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * i), _mm_aesenclast_si128(b, keys[10]));
+    }
+}
+
+bool hasHardwareAes()
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+    return ecx & bit_AES;
+}
+
+#elif defined(AES128_ARMV8)
+
+__attribute__((target("+crypto")))
+void encryptArmv8(const uint8_t roundKeys[176], const uint8_t *in, uint8_t *out, size_t count)
+{
+    uint8x16_t keys[11];
+    for (int i = 0; i < 11; ++i)
+        keys[i] = vld1q_u8(roundKeys + 16 * i);
+
+    // AESE does AddRoundKey, SubBytes and ShiftRows, AESMC MixColumns
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        uint8x16_t b0 = vld1q_u8(in + 16 * i);
+        uint8x16_t b1 = vld1q_u8(in + 16 * i + 16);
+        for (int round = 0; round < 9; ++round) {
+            b0 = vaesmcq_u8(vaeseq_u8(b0, keys[round]));
+            b1 = vaesmcq_u8(vaeseq_u8(b1, keys[round]));
+        }
+        vst1q_u8(out + 16 * i, veorq_u8(vaeseq_u8(b0, keys[9]), keys[10]));
+        vst1q_u8(out + 16 * i + 16, veorq_u8(vaeseq_u8(b1, keys[9]), keys[10]));
+    }
+    for (; i < count; ++i) {
+        uint8x16_t b = vld1q_u8(in + 16 * i);
+        for (int round = 0; round < 9; ++round)
+            b = vaesmcq_u8(vaeseq_u8(b, keys[round]));
+        vst1q_u8(out + 16 * i, veorq_u8(vaeseq_u8(b, keys[9]), keys[10]));
+    }
+}
+
+bool hasHardwareAes()
+{
+    return getauxval(AT_HWCAP) & HWCAP_AES;
+}
+
+#else
+
+bool hasHardwareAes()
+{
+    return false;
+}
+
+#endif
+
+// checked once, the answer can't change while the process runs
+bool useHardware()
+{
+    static const bool hardware = hasHardwareAes();
+    return hardware;
+}
+
+}
+
+Aes128::Aes128()
+{
+    memset(m_roundKeys, 0, sizeof(m_roundKeys));
+}
+
+Aes128::Aes128(const uint8_t key[16])
+{
+    setKey(key);
+}
+
+void Aes128::setKey(const uint8_t key[16])
+{
+    // the hardware paths consume the same FIPS-197 schedule, so one
+    // portable expansion serves all of them
+    expandKey(key, m_roundKeys);
+}
+
+void Aes128::encrypt(const uint8_t in[16], uint8_t out[16]) const
+{
+    encryptBlocks(in, out, 1);
+}
+
+void Aes128::encryptBlocks(const uint8_t *in, uint8_t *out, size_t count) const
+{
+#if defined(AES128_AESNI)
+    if (useHardware()) {
+        encryptAesNi(m_roundKeys, in, out, count);
+        return;
+    }
+#elif defined(AES128_ARMV8)
+    if (useHardware()) {
+        encryptArmv8(m_roundKeys, in, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i)
+        encryptPortable(m_roundKeys, in + 16 * i, out + 16 * i);
+}
+
+const char *Aes128::implementation()
+{
+    if (!useHardware())
+        return "portable";
+#if defined(AES128_AESNI)
+    return "aes-ni";
+#else
+    return "armv8";
+#endif
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef AES128_H
+#define AES128_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// AES-128 encryption of single 16 byte blocks, which is all the Bluetooth
+// security functions need. Uses AES-NI on x86 and the crypto extension
+// on 64 bit ARM when the CPU has them, checked at run time, and a
+// portable implementation otherwise. Bytes are in the order of FIPS-197,
+// i.e. most significant octet first as in the Bluetooth specification.
+class Aes128
+{
+public:
+    Aes128();
+    explicit Aes128(const uint8_t key[16]);
+
+    void setKey(const uint8_t key[16]);
+    void encrypt(const uint8_t in[16], uint8_t out[16]) const;
+    // encrypts count consecutive blocks, interleaved where the hardware
+    // can keep several blocks in flight
+    void encryptBlocks(const uint8_t *in, uint8_t *out, size_t count) const;
+
+    // which implementation is in use: "aes-ni", "armv8" or "portable"
+    static const char *implementation();
+
+private:
+    // 11 round keys of 16 bytes
+    uint8_t m_roundKeys[176];
+};
+
+#endif // AES128_H
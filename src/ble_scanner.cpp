@@ -33,12 +33,28 @@
 #endif
 
 #include <sailfishapp.h>
+#include <QQuickWindow>
+#include <QElapsedTimer>
+#include <QDebug>
 
 #include "device.h"
+#include "scanscheduler.h"
+#include "scanexporter.h"
+#include "gattsnapshot.h"
+#include "signalplot.h"
+#include "fleetaudit.h"
+#include "memorystats.h"
+#include "peripheralemulator.h"
+#include "latencyprobe.h"
+#include "historystore.h"
+#include "scanstats.h"
 
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startup;
+    startup.start();
+
     // SailfishApp::main() will display "qml/template.qml", if you need more
     // control over initialization, you can use:
     //
@@ -59,9 +75,46 @@ int main(int argc, char *argv[])
                                          "qt.bluetooth.bluez.debug=true\n"
                                          "qt.bluetooth.debug=true");
 
+    qmlRegisterType<SignalPlot>("harbour.ble_scanner", 1, 0, "SignalPlot");
+    qmlRegisterUncreatableType<SampleSeries>("harbour.ble_scanner", 1, 0, "SampleSeries",
+                                             "SampleSeries is provided by the device");
+
     Device d;
+    ScanScheduler scheduler(&d);
+    ScanExporter exporter(&d);
+    GattSnapshots snapshots(&d);
+    FleetAudit audit(&d);
+    MemoryStats memoryStats(&d, &audit);
+    PeripheralEmulator peripheral;
+    LatencyProbe latency(&d);
+    HistoryStore history(&d);
+    ScanStats scanStats(&d);
+    QObject::connect(&audit, &FleetAudit::runningChanged, &scheduler, [&scheduler, &audit]() {
+        scheduler.setPaused(audit.running());
+    });
     view->engine()->rootContext()->setContextProperty("device", &d);
-    view->setSource(SailfishApp::pathTo("qml/pages/MainPage.qml"));
+    view->engine()->rootContext()->setContextProperty("scheduler", &scheduler);
+    view->engine()->rootContext()->setContextProperty("presence", d.presence());
+    view->engine()->rootContext()->setContextProperty("keyring", d.keyring());
+    view->engine()->rootContext()->setContextProperty("exporter", &exporter);
+    view->engine()->rootContext()->setContextProperty("snapshots", &snapshots);
+    view->engine()->rootContext()->setContextProperty("audit", &audit);
+    view->engine()->rootContext()->setContextProperty("memoryStats", &memoryStats);
+    view->engine()->rootContext()->setContextProperty("peripheral", &peripheral);
+    view->engine()->rootContext()->setContextProperty("latency", &latency);
+    view->engine()->rootContext()->setContextProperty("history", &history);
+    view->engine()->rootContext()->setContextProperty("scanStats", &scanStats);
+    // the application window provides the cover shown in the background
+    view->setSource(SailfishApp::pathTo("qml/ble_scanner.qml"));
+
+    // Report the cold start time once the first frame is on screen.
+    bool firstFrame = true;
+    QObject::connect(view, &QQuickWindow::frameSwapped, view, [&startup, &firstFrame]() {
+        if (!firstFrame)
+            return;
+        firstFrame = false;
+        qInfo() << "First frame after" << startup.elapsed() << "ms";
+    });
 
     view->show();
 
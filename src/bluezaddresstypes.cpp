@@ -0,0 +1,132 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "bluezaddresstypes.h"
+#include <QDBusConnection>
+#include <QDBusObjectPath>
+#include <QDebug>
+#include <QVariantMap>
+
+namespace {
+
+const char *bluezService = "org.bluez";
+const char *objectManager = "org.freedesktop.DBus.ObjectManager";
+const char *deviceInterface = "org.bluez.Device1";
+// the table is cleared past this size, BlueZ announces the devices
+// still around again when they are rediscovered
+const int maxTypes = 4096;
+
+}
+
+BluezAddressTypes::BluezAddressTypes(QObject *parent):
+    QObject(parent), m_subscribed(false)
+{
+}
+
+BluezAddressTypes::AddressType BluezAddressTypes::lookup(const QString &address)
+{
+    if (!m_subscribed)
+        subscribe();
+    return m_types.value(address, Unknown);
+}
+
+void BluezAddressTypes::subscribe()
+{
+    m_subscribed = true;
+
+    QDBusConnection bus = QDBusConnection::systemBus();
+    if (!bus.connect(QLatin1String(bluezService), QStringLiteral("/"), QLatin1String(objectManager),
+                     QStringLiteral("InterfacesAdded"), this, SLOT(interfacesAdded(QDBusMessage))))
+        qWarning() << "Cannot watch BlueZ objects:" << bus.lastError().message();
+
+    QDBusMessage call = QDBusMessage::createMethodCall(QLatin1String(bluezService),
+                                                      QStringLiteral("/"),
+                                                      QLatin1String(objectManager),
+                                                      QStringLiteral("GetManagedObjects"));
+    const QDBusMessage reply = bus.call(call, QDBus::Block, 1000);
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qWarning() << "Cannot read BlueZ objects:" << reply.errorMessage();
+        return;
+    }
+
+    // a{oa{sa{sv}}}: object path -> interface -> property -> value
+    const QDBusArgument objects = reply.arguments().first().value<QDBusArgument>();
+    objects.beginMap();
+    while (!objects.atEnd()) {
+        QDBusObjectPath path;
+        objects.beginMapEntry();
+        objects >> path;
+        readInterfaces(objects);
+        objects.endMapEntry();
+    }
+    objects.endMap();
+}
+
+void BluezAddressTypes::interfacesAdded(const QDBusMessage &message)
+{
+    // (o, a{sa{sv}})
+    if (message.arguments().size() < 2)
+        return;
+    readInterfaces(message.arguments().at(1).value<QDBusArgument>());
+}
+
+void BluezAddressTypes::readInterfaces(const QDBusArgument &interfaces)
+{
+    interfaces.beginMap();
+    while (!interfaces.atEnd()) {
+        QString interface;
+        QVariantMap properties;
+        interfaces.beginMapEntry();
+        interfaces >> interface >> properties;
+        interfaces.endMapEntry();
+
+        if (interface == QLatin1String(deviceInterface))
+            insert(properties.value(QStringLiteral("Address")).toString(),
+                   properties.value(QStringLiteral("AddressType")).toString());
+    }
+    interfaces.endMap();
+}
+
+void BluezAddressTypes::insert(const QString &address, const QString &type)
+{
+    if (address.isEmpty() || type.isEmpty())
+        return;
+
+    if (m_types.size() >= maxTypes)
+        m_types.clear();
+    m_types.insert(address.toUpper(), type == QLatin1String("random") ? Random : Public);
+}
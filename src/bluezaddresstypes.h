@@ -0,0 +1,77 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef BLUEZADDRESSTYPES_H
+#define BLUEZADDRESSTYPES_H
+
+#include <QObject>
+#include <QDBusArgument>
+#include <QDBusMessage>
+#include <QHash>
+#include <QString>
+
+// Address types ("public" or "random") of the devices BlueZ knows about,
+// read from the AddressType property of org.bluez.Device1. The devices
+// known at the first lookup come from one GetManagedObjects call, later
+// ones from the InterfacesAdded signal, so lookups never block on the
+// bus. Rotating private addresses add new entries all the time, the
+// table is dropped once it grows past a fixed size.
+class BluezAddressTypes: public QObject
+{
+    Q_OBJECT
+public:
+    enum AddressType { Unknown, Public, Random };
+
+    explicit BluezAddressTypes(QObject *parent = 0);
+
+    // call from the thread the object lives in
+    AddressType lookup(const QString &address);
+
+private slots:
+    void interfacesAdded(const QDBusMessage &message);
+
+private:
+    void subscribe();
+    // reads the a{sa{sv}} interface map of one object
+    void readInterfaces(const QDBusArgument &interfaces);
+    void insert(const QString &address, const QString &type);
+
+    QHash<QString, AddressType> m_types;
+    bool m_subscribed;
+};
+
+#endif // BLUEZADDRESSTYPES_H
@@ -59,14 +59,19 @@ void CharacteristicInfo::setCharacteristic(const QLowEnergyCharacteristic &chara
 }
 
 QString CharacteristicInfo::getName() const
+{
+    return nameOf(m_characteristic);
+}
+
+QString CharacteristicInfo::nameOf(const QLowEnergyCharacteristic &characteristic)
 {
     //! [les-get-descriptors]
-    QString name = m_characteristic.name();
+    QString name = characteristic.name();
     if (!name.isEmpty())
         return name;
 
     // find descriptor with CharacteristicUserDescription
-    foreach (const QLowEnergyDescriptor &descriptor, m_characteristic.descriptors()) {
+    foreach (const QLowEnergyDescriptor &descriptor, characteristic.descriptors()) {
         if (descriptor.type() == QBluetoothUuid::CharacteristicUserDescription) {
             name = descriptor.value();
             break;
@@ -82,7 +87,12 @@ QString CharacteristicInfo::getName() const
 
 QString CharacteristicInfo::getUuid() const
 {
-    const QBluetoothUuid uuid = m_characteristic.uuid();
+    return uuidOf(m_characteristic);
+}
+
+QString CharacteristicInfo::uuidOf(const QLowEnergyCharacteristic &characteristic)
+{
+    const QBluetoothUuid uuid = characteristic.uuid();
     bool success = false;
     quint16 result16 = uuid.toUInt16(&success);
     if (success)
@@ -97,7 +107,9 @@ QString CharacteristicInfo::getUuid() const
 
 QString CharacteristicInfo::getValue() const
 {
-    // Show raw string first and hex value below
+    // Show raw string first and hex value below. Long values are cut
+    // short here, the hex viewer shows them whole.
+    const int previewSize = 32;
     QByteArray a = m_characteristic.value();
     QString result;
     if (a.isEmpty()) {
@@ -105,39 +117,59 @@ QString CharacteristicInfo::getValue() const
         return result;
     }
 
-    result = a;
+    const QByteArray preview = a.left(previewSize);
+    result = preview;
     result += QLatin1Char('\n');
-    result += a.toHex();
+    result += preview.toHex();
+    if (a.size() > previewSize)
+        result += QString(" ... (%1 bytes)").arg(a.size());
 
     return result;
 }
 
 QString CharacteristicInfo::getHandle() const
 {
-    return QStringLiteral("0x") + QString::number(m_characteristic.handle(), 16);
+    return handleOf(m_characteristic);
+}
+
+QString CharacteristicInfo::handleOf(const QLowEnergyCharacteristic &characteristic)
+{
+    return QStringLiteral("0x") + QString::number(characteristic.handle(), 16);
 }
 
 QString CharacteristicInfo::getPermission() const
 {
     QString properties = "( ";
-    int permission = m_characteristic.properties();
+    foreach (const QString &name, propertyNames())
+        properties += QLatin1Char(' ') + name;
+    properties += " )";
+    return properties;
+}
+
+QStringList CharacteristicInfo::propertyNames() const
+{
+    return propertyNames(m_characteristic.properties());
+}
+
+QStringList CharacteristicInfo::propertyNames(int permission)
+{
+    QStringList properties;
     if (permission & QLowEnergyCharacteristic::Read)
-        properties += QStringLiteral(" Read");
+        properties += QStringLiteral("Read");
     if (permission & QLowEnergyCharacteristic::Write)
-        properties += QStringLiteral(" Write");
+        properties += QStringLiteral("Write");
     if (permission & QLowEnergyCharacteristic::Notify)
-        properties += QStringLiteral(" Notify");
+        properties += QStringLiteral("Notify");
     if (permission & QLowEnergyCharacteristic::Indicate)
-        properties += QStringLiteral(" Indicate");
+        properties += QStringLiteral("Indicate");
     if (permission & QLowEnergyCharacteristic::ExtendedProperty)
-        properties += QStringLiteral(" ExtendedProperty");
+        properties += QStringLiteral("ExtendedProperty");
     if (permission & QLowEnergyCharacteristic::Broadcasting)
-        properties += QStringLiteral(" Broadcast");
+        properties += QStringLiteral("Broadcast");
     if (permission & QLowEnergyCharacteristic::WriteNoResponse)
-        properties += QStringLiteral(" WriteNoResp");
+        properties += QStringLiteral("WriteNoResp");
     if (permission & QLowEnergyCharacteristic::WriteSigned)
-        properties += QStringLiteral(" WriteSigned");
-    properties += " )";
+        properties += QStringLiteral("WriteSigned");
     return properties;
 }
 
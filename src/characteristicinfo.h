@@ -43,9 +43,11 @@
 #define CHARACTERISTICINFO_H
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QtBluetooth/QLowEnergyCharacteristic>
+#include "instancecounter.h"
 
-class CharacteristicInfo: public QObject
+class CharacteristicInfo: public QObject, public InstanceCounted<CharacteristicInfo>
 {
     Q_OBJECT
     Q_PROPERTY(QString characteristicName READ getName NOTIFY characteristicChanged)
@@ -63,6 +65,12 @@ public:
     QString getValue() const;
     QString getHandle() const;
     QString getPermission() const;
+    QStringList propertyNames() const;
+    static QStringList propertyNames(int properties);
+    // formatting without a CharacteristicInfo, for exports and lookups
+    static QString nameOf(const QLowEnergyCharacteristic &characteristic);
+    static QString uuidOf(const QLowEnergyCharacteristic &characteristic);
+    static QString handleOf(const QLowEnergyCharacteristic &characteristic);
     QLowEnergyCharacteristic getCharacteristic() const;
 
 Q_SIGNALS:
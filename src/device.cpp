@@ -43,68 +43,238 @@
 #include <qbluetoothaddress.h>
 #include <qbluetoothdevicediscoveryagent.h>
 #include <qbluetoothlocaldevice.h>
+#include <qbluetoothhostinfo.h>
 #include <qbluetoothdeviceinfo.h>
 #include <qbluetoothservicediscoveryagent.h>
 #include <QDebug>
 #include <QList>
 #include <QTimer>
+#include <QDateTime>
+#include <QSettings>
 #include <QDBusConnection>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+// an attempt with the wrong address type usually hangs rather than fails,
+// this is how long it is given before trying the other type
+const int connectTimeout = 10000;
+
+bool decodeSample(const QByteArray &value, const QString &format, double *sample)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(value.constData());
+    const int size = value.size();
+
+    if (format == QLatin1String("uint8") && size >= 1)
+        *sample = data[0];
+    else if (format == QLatin1String("int8") && size >= 1)
+        *sample = qint8(data[0]);
+    else if (format == QLatin1String("uint16") && size >= 2)
+        *sample = qFromLittleEndian<quint16>(data);
+    else if (format == QLatin1String("int16") && size >= 2)
+        *sample = qFromLittleEndian<qint16>(data);
+    else if (format == QLatin1String("uint32") && size >= 4)
+        *sample = qFromLittleEndian<quint32>(data);
+    else if (format == QLatin1String("int32") && size >= 4)
+        *sample = qFromLittleEndian<qint32>(data);
+    else if (format == QLatin1String("float") && size >= 4) {
+        const quint32 bits = qFromLittleEndian<quint32>(data);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        *sample = f;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+}
 
 Device::Device():
-    connected(false), controller(0), m_deviceScanState(false), randomAddress(false)
-{
-    //! [les-devicediscovery-1]
-    discoveryAgent = new QBluetoothDeviceDiscoveryAgent();
-    //discoveryAgent->setLowEnergyDiscoveryTimeout(5000);
-    connect(discoveryAgent, SIGNAL(deviceDiscovered(const QBluetoothDeviceInfo&)),
-            this, SLOT(addDevice(const QBluetoothDeviceInfo&)));
-    connect(discoveryAgent, SIGNAL(error(QBluetoothDeviceDiscoveryAgent::Error)),
-            this, SLOT(deviceScanError(QBluetoothDeviceDiscoveryAgent::Error)));
-    connect(discoveryAgent, SIGNAL(finished()), this, SLOT(deviceScanFinished()));
-    //! [les-devicediscovery-1]
+    m_worker(0), m_discoveryQueue(1024), m_deviceModel(&m_presence),
+    m_sortedDevices(&m_deviceModel), m_searchDirty(false),
+    m_plotFormat(QStringLiteral("int16")), m_connectRandom(false),
+    m_connectRetried(false), m_connectTime(-1), connected(false), controller(0),
+    m_deviceScanState(false), randomAddress(false)
+{
+    // Discovery runs on its own thread, results come back through
+    // m_discoveryQueue which is drained once per frame while scanning.
+    m_worker = new DiscoveryWorker(&m_discoveryQueue);
+    m_worker->moveToThread(&m_workerThread);
+    connect(&m_workerThread, SIGNAL(finished()), m_worker, SLOT(deleteLater()));
+    connect(m_worker, SIGNAL(recordsAvailable()), this, SLOT(wakeDrain()));
+    connect(m_worker, SIGNAL(scanError(int)), this, SLOT(deviceScanError(int)));
+    connect(m_worker, SIGNAL(scanStopped(bool)), this, SLOT(deviceScanStopped(bool)));
+    m_workerThread.start();
+
+    m_drainTimer.setInterval(16);
+    connect(&m_drainTimer, SIGNAL(timeout()), this, SLOT(drainDiscoveryQueue()));
+
+    connect(&m_presence, SIGNAL(deviceLeft(QString)), this, SLOT(deviceAged(QString)));
+
+    m_connectTimeout.setSingleShot(true);
+    m_connectTimeout.setInterval(connectTimeout);
+    connect(&m_connectTimeout, SIGNAL(timeout()), this, SLOT(connectTimedOut()));
+
+    QSettings settings;
+    settings.beginGroup("addressTypes");
+    foreach (const QString &key, settings.childKeys())
+        m_addressTypes.insert(key, settings.value(key).toString() == "random");
+    settings.endGroup();
 
     setUpdate("Search");
 }
 
 Device::~Device()
 {
-    delete discoveryAgent;
+    m_workerThread.quit();
+    m_workerThread.wait();
     delete controller;
     qDeleteAll(devices);
     qDeleteAll(m_services);
     qDeleteAll(m_characteristics);
     devices.clear();
+    m_deviceIndex.clear();
     m_services.clear();
     m_characteristics.clear();
 }
 
 void Device::startDeviceDiscovery()
 {
-    qDeleteAll(devices);
-    devices.clear();
-    emit devicesUpdated();
-
+    // Devices are kept across scans, the presence tracker removes the
+    // ones which have not been seen for a while.
     setUpdate("Scanning for devices ...");
-    //! [les-devicediscovery-2]
-    discoveryAgent->start();
-    //! [les-devicediscovery-2]
+    QMetaObject::invokeMethod(m_worker, "start", Qt::QueuedConnection);
 
-    if (discoveryAgent->isActive()) {
+    // the worker reports back through deviceScanStopped() if no agent
+    // could be started
+    m_drainTimer.start();
+    if (!m_deviceScanState) {
         m_deviceScanState = true;
         Q_EMIT stateChanged();
     }
 }
 
-//! [les-devicediscovery-3]
-void Device::addDevice(const QBluetoothDeviceInfo &info)
+void Device::stopDeviceDiscovery()
+{
+    QMetaObject::invokeMethod(m_worker, "stop", Qt::QueuedConnection);
+}
+
+QStringList Device::adapters() const
+{
+    QStringList result;
+    foreach (const QBluetoothHostInfo &host, QBluetoothLocalDevice::allDevices())
+        result.append(host.address().toString());
+    return result;
+}
+
+QString Device::adapter() const
+{
+    return m_adapter;
+}
+
+void Device::setAdapter(const QString &adapter)
 {
-    if (info.coreConfigurations() & QBluetoothDeviceInfo::LowEnergyCoreConfiguration) {
-        DeviceInfo *d = new DeviceInfo(info);
-        devices.append(d);
-        setUpdate("Last device added: " + d->getName());
+    if (adapter == m_adapter)
+        return;
+
+    m_adapter = adapter;
+    QMetaObject::invokeMethod(m_worker, "setAdapter", Qt::QueuedConnection,
+                              Q_ARG(QString, adapter));
+    emit adapterChanged();
+}
+
+void Device::wakeDrain()
+{
+    if (!m_drainTimer.isActive())
+        m_drainTimer.start();
+}
+
+void Device::drainDiscoveryQueue()
+{
+    DiscoveryRecord record;
+    if (m_keyring.count() == 0) {
+        while (m_discoveryQueue.pop(record))
+            addDevice(record);
+    } else {
+        // private addresses of the whole pass are resolved in one batch
+        m_drainBatch.resize(0);
+        m_drainAddresses.resize(0);
+        while (m_discoveryQueue.pop(record)) {
+            m_drainBatch.append(record);
+            m_drainAddresses.append(record.address);
+        }
+        m_keyring.resolve(m_drainAddresses);
+        foreach (const DiscoveryRecord &pending, m_drainBatch)
+            addDevice(pending);
     }
+
+    // at most one search per frame, however many devices came in
+    if (m_searchDirty)
+        runSearch();
+
+    if (!m_deviceScanState)
+        m_drainTimer.stop();
+}
+
+void Device::addDevice(const DiscoveryRecord &record)
+{
+    // devices with a resolved private address are kept under their identity
+    const QString address = m_keyring.identity(record.address);
+    m_presence.seen(address, record.timestamp);
+    if (record.addressType != BluezAddressTypes::Unknown)
+        m_addressTypes.insert(address, record.addressType == BluezAddressTypes::Random);
+
+    // the same device reported by several adapters is merged into
+    // one entry which remembers the RSSI seen by each adapter
+    DeviceInfo *d = m_deviceIndex.value(address);
+    const bool known = d;
+    if (!d)
+        d = new DeviceInfo(record.info);
+    d->setDevice(record.info, record.adapter);
+    if (address != record.address)
+        d->setIdentity(address, m_keyring.identityName(address));
+    // a resolved address is always a random one, otherwise only trust a
+    // type BlueZ reported or a connection confirmed, not the default
+    QHash<QString, bool>::const_iterator type = m_addressTypes.constFind(address);
+    d->setRandomAddress(address != record.address
+                        || (type != m_addressTypes.constEnd() && *type));
+
+    // names and service lists often only arrive with a later advertisement
+    if (m_searchIndex.update(address, d->getName(), address, d->getServiceUuids())
+            && !m_searchQuery.isEmpty())
+        m_searchDirty = true;
+    if (known) {
+        m_deviceModel.deviceChanged(d);
+        emit deviceSeen(address);
+        return;
+    }
+
+    devices.append(d);
+    m_deviceIndex.insert(address, d);
+    m_deviceModel.append(d);
+    // listeners look the device up, it has to be indexed first
+    emit deviceSeen(address);
+    setUpdate("Last device added: " + d->getName());
+    emit deviceEntered(d);
+}
+
+void Device::deviceScanStopped(bool failed)
+{
+    drainDiscoveryQueue();
+    if (!m_deviceScanState)
+        return;
+
+    if (failed) {
+        // the error message was already set by deviceScanError()
+        m_deviceScanState = false;
+        emit devicesUpdated();
+        emit stateChanged();
+        return;
+    }
+    deviceScanFinished();
 }
-//! [les-devicediscovery-3]
 
 void Device::deviceScanFinished()
 {
@@ -122,6 +292,127 @@ QVariant Device::getDevices()
     return QVariant::fromValue(devices);
 }
 
+QObject *Device::deviceModel()
+{
+    return &m_sortedDevices;
+}
+
+void Device::deviceAged(const QString &address)
+{
+    DeviceInfo *d = m_deviceIndex.take(address);
+    if (!d)
+        return;
+
+    devices.removeOne(d);
+    m_deviceModel.remove(d);
+    m_searchIndex.remove(address);
+    if (m_searchResults.removeOne(d))
+        emit searchResultsChanged();
+    emit deviceLeft(address);
+    emit devicesUpdated();
+    // QML may still hold a reference until the list is re-read
+    d->deleteLater();
+}
+
+QString Device::searchQuery() const
+{
+    return m_searchQuery;
+}
+
+void Device::setSearchQuery(const QString &query)
+{
+    if (query == m_searchQuery)
+        return;
+
+    m_searchQuery = query;
+    runSearch();
+}
+
+QVariant Device::getSearchResults()
+{
+    return QVariant::fromValue(m_searchResults);
+}
+
+QList<DeviceInfo*> Device::matchingDevices(const QString &query) const
+{
+    QList<DeviceInfo*> result;
+    if (query.isEmpty()) {
+        foreach (QObject *object, devices)
+            result.append((DeviceInfo*)object);
+        return result;
+    }
+
+    foreach (const QString &address, m_searchIndex.search(query, 500)) {
+        DeviceInfo *d = m_deviceIndex.value(address);
+        if (d)
+            result.append(d);
+    }
+    return result;
+}
+
+void Device::runSearch()
+{
+    m_searchDirty = false;
+    m_searchResults.clear();
+    foreach (DeviceInfo *d, matchingDevices(m_searchQuery))
+        m_searchResults.append(d);
+    emit searchResultsChanged();
+}
+
+int Device::droppedRecords() const
+{
+    return m_worker->droppedRecords();
+}
+
+PresenceTracker *Device::presence()
+{
+    return &m_presence;
+}
+
+IrkKeyring *Device::keyring()
+{
+    return &m_keyring;
+}
+
+const QList<QObject*> &Device::deviceObjects() const
+{
+    return devices;
+}
+
+const QList<QObject*> &Device::serviceObjects() const
+{
+    return m_services;
+}
+
+const QList<QObject*> &Device::characteristicObjects() const
+{
+    return m_characteristics;
+}
+
+int Device::lowEnergyServices() const
+{
+    // ServiceInfo takes over the parentship of the services it wraps
+    int count = controller ? controller->findChildren<QLowEnergyService*>().size() : 0;
+    foreach (QObject *object, m_services)
+        count += object->findChildren<QLowEnergyService*>().size();
+    return count;
+}
+
+DeviceInfo *Device::deviceInfo(const QString &address) const
+{
+    return m_deviceIndex.value(address);
+}
+
+QLowEnergyService *Device::currentService() const
+{
+    return m_currentService;
+}
+
+const DeviceInfo *Device::connectedDevice() const
+{
+    return &currentDevice;
+}
+
 QVariant Device::getServices()
 {
     return QVariant::fromValue(m_services);
@@ -141,9 +432,11 @@ void Device::scanServices(const QString &address)
 {
     // We need the current device for service discovery.
 
-    for (int i = 0; i < devices.size(); i++) {
-        if (((DeviceInfo*)devices.at(i))->getAddress() == address )
-            currentDevice.setDevice(((DeviceInfo*)devices.at(i))->getDevice());
+    DeviceInfo *d = m_deviceIndex.value(address);
+    QString adapter;
+    if (d) {
+        currentDevice.setDevice(d->getDevice());
+        adapter = d->bestAdapter();
     }
 
     if (!currentDevice.getDevice().isValid()) {
@@ -160,36 +453,104 @@ void Device::scanServices(const QString &address)
 
     setUpdate("Back\n(Connecting to device...)");
 
-    if (controller && m_previousAddress != currentDevice.getAddress()) {
+    if (controller && (m_previousAddress != currentDevice.getAddress()
+                       || m_previousAdapter != adapter)) {
         controller->disconnectFromDevice();
         delete controller;
         controller = 0;
     }
 
     //! [les-controller-1]
-    if (!controller) {
-        // Connecting signals and slots for connecting to LE services.
+    if (!controller)
+        createController(adapter);
+
+    m_previousAddress = currentDevice.getAddress();
+    m_previousAdapter = adapter;
+
+    if (controller->state() != QLowEnergyController::UnconnectedState) {
+        controller->connectToDevice();
+        return;
+    }
+
+    connected = false;
+    m_connectAddress = address;
+    m_connectRetried = false;
+    m_connectClock.start();
+    connectWithAddressType(addressTypeFor(address));
+    //! [les-controller-1]
+}
+
+void Device::createController(const QString &adapter)
+{
+    // Connecting signals and slots for connecting to LE services.
+    if (adapter.isEmpty()) {
         controller = new QLowEnergyController(currentDevice.getDevice());
-        connect(controller, SIGNAL(connected()),
-                this, SLOT(deviceConnected()));
-        connect(controller, SIGNAL(error(QLowEnergyController::Error)),
-                this, SLOT(errorReceived(QLowEnergyController::Error)));
-        connect(controller, SIGNAL(disconnected()),
-                this, SLOT(deviceDisconnected()));
-        connect(controller, SIGNAL(serviceDiscovered(QBluetoothUuid)),
-                this, SLOT(addLowEnergyService(QBluetoothUuid)));
-        connect(controller, SIGNAL(discoveryFinished()),
-                this, SLOT(serviceScanDone()));
+    } else {
+        // connect through the adapter which hears the device best
+        controller = new QLowEnergyController(currentDevice.getDevice().address(),
+                                              QBluetoothAddress(adapter));
     }
+    connect(controller, SIGNAL(connected()),
+            this, SLOT(deviceConnected()));
+    connect(controller, SIGNAL(error(QLowEnergyController::Error)),
+            this, SLOT(errorReceived(QLowEnergyController::Error)));
+    connect(controller, SIGNAL(disconnected()),
+            this, SLOT(deviceDisconnected()));
+    connect(controller, SIGNAL(serviceDiscovered(QBluetoothUuid)),
+            this, SLOT(addLowEnergyService(QBluetoothUuid)));
+    connect(controller, SIGNAL(discoveryFinished()),
+            this, SLOT(serviceScanDone()));
+}
 
-    if (isRandomAddress())
+void Device::connectWithAddressType(bool random)
+{
+    m_connectRandom = random;
+    if (random)
         controller->setRemoteAddressType(QLowEnergyController::RandomAddress);
     else
         controller->setRemoteAddressType(QLowEnergyController::PublicAddress);
+    m_connectTimeout.start();
     controller->connectToDevice();
-    //! [les-controller-1]
+}
 
-    m_previousAddress = currentDevice.getAddress();
+bool Device::retryConnect()
+{
+    if (connected || m_connectRetried || !controller)
+        return false;
+
+    // the address type cannot be changed on a controller which is
+    // connecting, the retry goes through a fresh one
+    m_connectRetried = true;
+    m_connectTimeout.stop();
+    controller->disconnect(this);
+    controller->disconnectFromDevice();
+    controller->deleteLater();
+    controller = 0;
+    createController(m_previousAdapter);
+
+    const bool random = !m_connectRandom;
+    qWarning() << "Retrying" << m_connectAddress << "as" << (random ? "random" : "public");
+    setUpdate(QString("Back\n(Retrying with %1 address...)").arg(random ? "random" : "public"));
+    connectWithAddressType(random);
+    return true;
+}
+
+bool Device::addressTypeFor(const QString &address) const
+{
+    QHash<QString, bool>::const_iterator it = m_addressTypes.constFind(address);
+    if (it != m_addressTypes.constEnd())
+        return *it;
+    return randomAddress;
+}
+
+void Device::connectTimedOut()
+{
+    if (retryConnect())
+        return;
+
+    qWarning() << "Connection to" << m_connectAddress << "timed out";
+    controller->disconnectFromDevice();
+    setUpdate("Back\n(Connection timed out)");
 }
 
 void Device::addLowEnergyService(const QBluetoothUuid &serviceUuid)
@@ -230,15 +591,21 @@ void Device::connectToService(const QString &uuid)
     if (!service)
         return;
 
+    m_currentService = service;
+    m_inspectedCharacteristic = QLowEnergyCharacteristic();
     qDeleteAll(m_characteristics);
     m_characteristics.clear();
     emit characteristicsUpdated();
 
-    if (service->state() == QLowEnergyService::DiscoveryRequired) {
+    if (service->state() != QLowEnergyService::ServiceDiscovered) {
+        // the details may already be on their way, e.g. requested by a
+        // snapshot, in which case only the result is waited for
         //! [les-service-3]
         connect(service, SIGNAL(stateChanged(QLowEnergyService::ServiceState)),
-                this, SLOT(serviceDetailsDiscovered(QLowEnergyService::ServiceState)));
-        service->discoverDetails();
+                this, SLOT(serviceDetailsDiscovered(QLowEnergyService::ServiceState)),
+                Qt::UniqueConnection);
+        if (service->state() == QLowEnergyService::DiscoveryRequired)
+            service->discoverDetails();
         setUpdate("Back\n(Discovering details...)");
         //! [les-service-3]
         return;
@@ -256,8 +623,24 @@ void Device::connectToService(const QString &uuid)
 
 void Device::deviceConnected()
 {
-    setUpdate("Back\n(Discovering services...)");
+    m_connectTimeout.stop();
     connected = true;
+    // retries are for the connect phase only, an error after a normal
+    // disconnect must not reconnect with the other type
+    m_connectRetried = true;
+    m_connectTime = m_connectClock.elapsed();
+    emit connectTimeChanged();
+    setUpdate(QString("Back\n(Connected in %1 ms, discovering services...)").arg(m_connectTime));
+
+    if (!m_connectAddress.isEmpty() && (!m_addressTypes.contains(m_connectAddress)
+            || m_addressTypes.value(m_connectAddress) != m_connectRandom)) {
+        m_addressTypes.insert(m_connectAddress, m_connectRandom);
+        QSettings settings;
+        settings.beginGroup("addressTypes");
+        settings.setValue(m_connectAddress, m_connectRandom ? "random" : "public");
+        settings.endGroup();
+    }
+
     //! [les-service-2]
     controller->discoverServices();
     //! [les-service-2]
@@ -266,6 +649,9 @@ void Device::deviceConnected()
 void Device::errorReceived(QLowEnergyController::Error /*error*/)
 {
     qWarning() << "Error: " << controller->errorString();
+    if (retryConnect())
+        return;
+    m_connectTimeout.stop();
     setUpdate(QString("Back\n(%1)").arg(controller->errorString()));
 }
 
@@ -282,6 +668,8 @@ void Device::disconnectFromDevice()
     // and thus allowing UI to keep track of controller progress in addition to
     // device scan progress
 
+    // unsubscribe while the link is still up
+    stopPlot();
     if (controller->state() != QLowEnergyController::UnconnectedState)
         controller->disconnectFromDevice();
     else
@@ -291,11 +679,18 @@ void Device::disconnectFromDevice()
 void Device::deviceDisconnected()
 {
     qWarning() << "Disconnect from device";
+    stopPlot();
+    m_connectTimeout.stop();
+    connected = false;
     emit disconnected();
 }
 
 void Device::serviceDetailsDiscovered(QLowEnergyService::ServiceState newState)
 {
+    // services opened earlier stay connected, only the current one is listed
+    if (sender() != m_currentService)
+        return;
+
     if (newState != QLowEnergyService::ServiceDiscovered) {
         // do not hang in "Scanning for characteristics" mode forever
         // in case the service discovery failed
@@ -312,8 +707,6 @@ void Device::serviceDetailsDiscovered(QLowEnergyService::ServiceState newState)
     if (!service)
         return;
 
-
-
     //! [les-chars]
     const QList<QLowEnergyCharacteristic> chars = service->characteristics();
     foreach (const QLowEnergyCharacteristic &ch, chars) {
@@ -325,7 +718,7 @@ void Device::serviceDetailsDiscovered(QLowEnergyService::ServiceState newState)
     emit characteristicsUpdated();
 }
 
-void Device::deviceScanError(QBluetoothDeviceDiscoveryAgent::Error error)
+void Device::deviceScanError(int error)
 {
     if (error == QBluetoothDeviceDiscoveryAgent::PoweredOffError)
         setUpdate("The Bluetooth adaptor is powered off, power it on before doing discovery.");
@@ -333,10 +726,116 @@ void Device::deviceScanError(QBluetoothDeviceDiscoveryAgent::Error error)
         setUpdate("Writing or reading from the device resulted in an error.");
     else
         setUpdate("An unknown error has occurred.");
+}
 
-    m_deviceScanState = false;
-    emit devicesUpdated();
-    emit stateChanged();
+SampleSeries *Device::plotSeries()
+{
+    return &m_plotSeries;
+}
+
+QString Device::plotFormat() const
+{
+    return m_plotFormat;
+}
+
+void Device::setPlotFormat(const QString &format)
+{
+    if (format == m_plotFormat)
+        return;
+
+    m_plotFormat = format;
+    m_plotSeries.clear();
+    emit plotFormatChanged();
+}
+
+QObject *Device::valueModel()
+{
+    return &m_valueModel;
+}
+
+void Device::inspectValue(const QString &characteristicUuid)
+{
+    m_inspectedCharacteristic = findCharacteristic(characteristicUuid);
+    m_valueModel.setBuffer(m_inspectedCharacteristic.value());
+    if (m_inspectedCharacteristic.isValid()) {
+        connect(m_currentService, SIGNAL(characteristicChanged(QLowEnergyCharacteristic,QByteArray)),
+                this, SLOT(characteristicValueChanged(QLowEnergyCharacteristic,QByteArray)),
+                Qt::UniqueConnection);
+    }
+}
+
+void Device::startPlot(const QString &characteristicUuid)
+{
+    stopPlot();
+    m_plotSeries.clear();
+
+    const QLowEnergyCharacteristic characteristic = findCharacteristic(characteristicUuid);
+    if (!characteristic.isValid())
+        return;
+
+    m_plotCharacteristic = characteristic;
+    connect(m_currentService, SIGNAL(characteristicChanged(QLowEnergyCharacteristic,QByteArray)),
+            this, SLOT(characteristicValueChanged(QLowEnergyCharacteristic,QByteArray)),
+            Qt::UniqueConnection);
+    setNotifications(characteristic, true);
+
+    double sample;
+    if (decodeSample(characteristic.value(), m_plotFormat, &sample))
+        m_plotSeries.append(sample);
+}
+
+void Device::stopPlot()
+{
+    if (!m_plotCharacteristic.isValid())
+        return;
+
+    // after a disconnect the subscription is gone with the link
+    if (m_currentService && m_currentService->state() == QLowEnergyService::ServiceDiscovered)
+        setNotifications(m_plotCharacteristic, false);
+    m_plotCharacteristic = QLowEnergyCharacteristic();
+}
+
+void Device::characteristicValueChanged(const QLowEnergyCharacteristic &characteristic,
+                                        const QByteArray &value)
+{
+    if (m_inspectedCharacteristic.isValid()
+            && characteristic.handle() == m_inspectedCharacteristic.handle())
+        m_valueModel.setBuffer(value);
+
+    if (!m_plotCharacteristic.isValid()
+            || characteristic.handle() != m_plotCharacteristic.handle())
+        return;
+
+    double sample;
+    if (decodeSample(value, m_plotFormat, &sample))
+        m_plotSeries.append(sample);
+}
+
+QLowEnergyCharacteristic Device::findCharacteristic(const QString &uuid) const
+{
+    if (!m_currentService)
+        return QLowEnergyCharacteristic();
+
+    foreach (const QLowEnergyCharacteristic &ch, m_currentService->characteristics()) {
+        if (CharacteristicInfo::uuidOf(ch) == uuid)
+            return ch;
+    }
+    return QLowEnergyCharacteristic();
+}
+
+void Device::setNotifications(const QLowEnergyCharacteristic &characteristic, bool enable)
+{
+    const QLowEnergyDescriptor config =
+            characteristic.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration);
+    if (!config.isValid())
+        return;
+
+    QByteArray value = QByteArray::fromHex("0000");
+    if (enable && (characteristic.properties() & QLowEnergyCharacteristic::Notify))
+        value = QByteArray::fromHex("0100");
+    else if (enable && (characteristic.properties() & QLowEnergyCharacteristic::Indicate))
+        value = QByteArray::fromHex("0200");
+    m_currentService->writeDescriptor(config, value);
 }
 
 bool Device::state()
@@ -356,6 +855,11 @@ bool Device::isRandomAddress() const
     return randomAddress;
 }
 
+int Device::connectTime() const
+{
+    return m_connectTime;
+}
+
 void Device::setRandomAddress(bool newValue)
 {
     randomAddress = newValue;
@@ -46,6 +46,11 @@
 #include <QObject>
 #include <QVariant>
 #include <QList>
+#include <QHash>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
 #include <QBluetoothServiceDiscoveryAgent>
 #include <QBluetoothDeviceDiscoveryAgent>
 #include <QLowEnergyController>
@@ -53,6 +58,13 @@
 #include "deviceinfo.h"
 #include "serviceinfo.h"
 #include "characteristicinfo.h"
+#include "presencetracker.h"
+#include "discoveryworker.h"
+#include "devicesearchindex.h"
+#include "devicelistmodel.h"
+#include "sampleseries.h"
+#include "hexviewmodel.h"
+#include "irkkeyring.h"
 
 QT_FORWARD_DECLARE_CLASS (QBluetoothDeviceInfo)
 QT_FORWARD_DECLARE_CLASS (QBluetoothServiceInfo)
@@ -61,37 +73,112 @@ class Device: public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QVariant devicesList READ getDevices NOTIFY devicesUpdated)
+    Q_PROPERTY(QObject *deviceModel READ deviceModel CONSTANT)
     Q_PROPERTY(QVariant servicesList READ getServices NOTIFY servicesUpdated)
     Q_PROPERTY(QVariant characteristicList READ getCharacteristics NOTIFY characteristicsUpdated)
     Q_PROPERTY(QString update READ getUpdate WRITE setUpdate NOTIFY updateChanged)
     Q_PROPERTY(bool useRandomAddress READ isRandomAddress WRITE setRandomAddress NOTIFY randomAddressChanged)
     Q_PROPERTY(bool state READ state NOTIFY stateChanged)
+    Q_PROPERTY(QStringList adapters READ adapters CONSTANT)
+    Q_PROPERTY(QString adapter READ adapter WRITE setAdapter NOTIFY adapterChanged)
     Q_PROPERTY(bool controllerError READ hasControllerError)
+    Q_PROPERTY(QString searchQuery READ searchQuery WRITE setSearchQuery NOTIFY searchResultsChanged)
+    Q_PROPERTY(QVariant searchResults READ getSearchResults NOTIFY searchResultsChanged)
+    Q_PROPERTY(SampleSeries *plotSeries READ plotSeries CONSTANT)
+    Q_PROPERTY(QString plotFormat READ plotFormat WRITE setPlotFormat NOTIFY plotFormatChanged)
+    Q_PROPERTY(QObject *valueModel READ valueModel CONSTANT)
+    Q_PROPERTY(int connectTime READ connectTime NOTIFY connectTimeChanged)
 public:
     Device();
     ~Device();
     QVariant getDevices();
+    QObject *deviceModel();
     QVariant getServices();
     QVariant getCharacteristics();
     QString getUpdate();
     bool state();
     bool hasControllerError() const;
 
+    // Address type used for devices whose type is not known yet. BlueZ
+    // reports it with the discovery data and a successful connection
+    // remembers it per device; an attempt which fails or times out is
+    // retried once with the other type.
     bool isRandomAddress() const;
     void setRandomAddress(bool newValue);
+    // true if address is connected as a random address: the type
+    // remembered for it, or the default above for unknown devices
+    bool addressTypeFor(const QString &address) const;
+
+    // milliseconds from scanServices() to the connected state of the
+    // last connection, -1 before the first one
+    int connectTime() const;
+
+    // Local adapter used for discovery and connections: empty for the
+    // default adapter, "all" to scan on every adapter at once, otherwise
+    // the address of a single adapter.
+    QStringList adapters() const;
+    QString adapter() const;
+    void setAdapter(const QString &adapter);
+
+    // devices whose name, address or advertised service UUIDs contain
+    // the query, updated as new devices are discovered
+    QString searchQuery() const;
+    void setSearchQuery(const QString &query);
+    QVariant getSearchResults();
+    // the devices the search box shows for query, all of them if empty
+    QList<DeviceInfo*> matchingDevices(const QString &query) const;
+
+    // Notifications of the plotted characteristic are decoded as plotFormat
+    // ("uint8", "int8", "uint16", "int16", "uint32", "int32" or "float",
+    // little endian at offset 0) and appended to plotSeries.
+    SampleSeries *plotSeries();
+    QString plotFormat() const;
+    void setPlotFormat(const QString &format);
+
+    // rows of the value last opened with inspectValue(), kept up to date
+    // with its notifications
+    QObject *valueModel();
+
+    // advertisements lost because the discovery queue was full
+    int droppedRecords() const;
+    PresenceTracker *presence();
+    IrkKeyring *keyring();
+    const QList<QObject*> &deviceObjects() const;
+    const QList<QObject*> &serviceObjects() const;
+    const QList<QObject*> &characteristicObjects() const;
+    // QLowEnergyService objects reachable from the controller, whether or
+    // not a listed ServiceInfo holds them
+    int lowEnergyServices() const;
+    const DeviceInfo *connectedDevice() const;
+    DeviceInfo *deviceInfo(const QString &address) const;
+    // the service last opened with connectToService(), 0 if none
+    QLowEnergyService *currentService() const;
+    QLowEnergyCharacteristic findCharacteristic(const QString &uuid) const;
+    // writes the client characteristic configuration of a characteristic
+    // of the current service
+    void setNotifications(const QLowEnergyCharacteristic &characteristic, bool enable);
 
 public slots:
     void startDeviceDiscovery();
+    void stopDeviceDiscovery();
     void scanServices(const QString &address);
 
     void connectToService(const QString &uuid);
     void disconnectFromDevice();
 
+    void startPlot(const QString &characteristicUuid);
+    void inspectValue(const QString &characteristicUuid);
+    void stopPlot();
+
 private slots:
-    // QBluetoothDeviceDiscoveryAgent related
-    void addDevice(const QBluetoothDeviceInfo&);
-    void deviceScanFinished();
-    void deviceScanError(QBluetoothDeviceDiscoveryAgent::Error);
+    // DiscoveryWorker related
+    void wakeDrain();
+    void drainDiscoveryQueue();
+    void deviceScanStopped(bool failed);
+    void deviceScanError(int);
+
+    // PresenceTracker related
+    void deviceAged(const QString &address);
 
     // QLowEnergyController realted
     void addLowEnergyService(const QBluetoothUuid &uuid);
@@ -99,27 +186,75 @@ private slots:
     void errorReceived(QLowEnergyController::Error);
     void serviceScanDone();
     void deviceDisconnected();
+    void connectTimedOut();
 
     // QLowEnergyService related
     void serviceDetailsDiscovered(QLowEnergyService::ServiceState newState);
+    void characteristicValueChanged(const QLowEnergyCharacteristic &characteristic,
+                                    const QByteArray &value);
 
 Q_SIGNALS:
     void devicesUpdated();
+    void deviceSeen(const QString &address);
+    void deviceEntered(QObject *device);
+    void deviceLeft(const QString &address);
     void servicesUpdated();
     void characteristicsUpdated();
     void updateChanged();
     void stateChanged();
     void disconnected();
     void randomAddressChanged();
+    void adapterChanged();
+    void searchResultsChanged();
+    void plotFormatChanged();
+    void connectTimeChanged();
 
 private:
     void setUpdate(QString message);
-    QBluetoothDeviceDiscoveryAgent *discoveryAgent;
+    void addDevice(const DiscoveryRecord &record);
+    void deviceScanFinished();
+    void runSearch();
+    void createController(const QString &adapter);
+    void connectWithAddressType(bool random);
+    bool retryConnect();
+    QThread m_workerThread;
+    DiscoveryWorker *m_worker;
+    DiscoveryQueue m_discoveryQueue;
+    QTimer m_drainTimer;
     DeviceInfo currentDevice;
     QList<QObject*> devices;
+    QHash<QString, DeviceInfo*> m_deviceIndex;
+    PresenceTracker m_presence;
+    IrkKeyring m_keyring;
+    // records of one drain pass, resolved against the keyring together
+    QVector<DiscoveryRecord> m_drainBatch;
+    QVector<QString> m_drainAddresses;
+    DeviceListModel m_deviceModel;
+    SortedDeviceModel m_sortedDevices;
+    DeviceSearchIndex m_searchIndex;
+    QString m_searchQuery;
+    QList<QObject*> m_searchResults;
+    bool m_searchDirty;
     QList<QObject*> m_services;
     QList<QObject*> m_characteristics;
+    QPointer<QLowEnergyService> m_currentService;
+    QLowEnergyCharacteristic m_plotCharacteristic;
+    QLowEnergyCharacteristic m_inspectedCharacteristic;
+    QString m_plotFormat;
+    SampleSeries m_plotSeries;
+    HexViewModel m_valueModel;
     QString m_previousAddress;
+    QString m_previousAdapter;
+    // device address -> random address type, from discovery data and
+    // from successful connections (the latter saved in the settings)
+    QHash<QString, bool> m_addressTypes;
+    QString m_connectAddress;
+    bool m_connectRandom;
+    bool m_connectRetried;
+    QTimer m_connectTimeout;
+    QElapsedTimer m_connectClock;
+    int m_connectTime;
+    QString m_adapter;
     QString m_message;
     bool connected;
     QLowEnergyController *controller;
@@ -40,32 +40,121 @@
 ****************************************************************************/
 
 #include <qbluetoothuuid.h>
+#include <climits>
 
 #include "deviceinfo.h"
 
-DeviceInfo::DeviceInfo()
+DeviceInfo::DeviceInfo():
+    m_randomAddress(false)
 {
 }
 
-DeviceInfo::DeviceInfo(const QBluetoothDeviceInfo &d)
+DeviceInfo::DeviceInfo(const QBluetoothDeviceInfo &d):
+    m_randomAddress(false)
 {
     device = d;
 }
 
 QString DeviceInfo::getAddress() const
+{
+    if (!m_identity.isEmpty())
+        return m_identity;
+    return addressOf(device);
+}
+
+QString DeviceInfo::addressOf(const QBluetoothDeviceInfo &d)
 {
 #ifdef Q_OS_MAC
     // On OS X and iOS we do not have addresses,
     // only unique UUIDs generated by Core Bluetooth.
-    return device.deviceUuid().toString();
+    return d.deviceUuid().toString();
 #else
-    return device.address().toString();
+    return d.address().toString();
 #endif
 }
 
 QString DeviceInfo::getName() const
 {
-    return device.name();
+    const QString name = device.name();
+    if (name.isEmpty())
+        return m_identityName;
+    return name;
+}
+
+int DeviceInfo::getRssi() const
+{
+    if (m_adapterRssi.isEmpty())
+        return device.rssi();
+
+    return m_adapterRssi.value(bestAdapter());
+}
+
+QString DeviceInfo::getAdapterRssi() const
+{
+    QStringList result;
+    QHash<QString, int>::const_iterator it = m_adapterRssi.constBegin();
+    for (; it != m_adapterRssi.constEnd(); ++it) {
+        const QString adapter = it.key().isEmpty() ? QStringLiteral("default") : it.key();
+        result.append(QString("%1: %2 dBm").arg(adapter).arg(it.value()));
+    }
+    return result.join(QStringLiteral(", "));
+}
+
+QString DeviceInfo::bestAdapter() const
+{
+    QString best;
+    int bestRssi = INT_MIN;
+    QHash<QString, int>::const_iterator it = m_adapterRssi.constBegin();
+    for (; it != m_adapterRssi.constEnd(); ++it) {
+        if (it.value() > bestRssi) {
+            bestRssi = it.value();
+            best = it.key();
+        }
+    }
+    return best;
+}
+
+QStringList DeviceInfo::getServiceUuids() const
+{
+    QStringList result;
+    foreach (const QBluetoothUuid &uuid, device.serviceUuids())
+        result.append(uuid.toString().remove(QLatin1Char('{')).remove(QLatin1Char('}')));
+    return result;
+}
+
+QString DeviceInfo::getManufacturerData() const
+{
+    // Advertised manufacturer data as "<company id>:<hex payload>" pairs
+    QString result;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    const QHash<quint16, QByteArray> data = device.manufacturerData();
+    QHash<quint16, QByteArray>::const_iterator it = data.constBegin();
+    for (; it != data.constEnd(); ++it) {
+        if (!result.isEmpty())
+            result += QLatin1Char(' ');
+        result += QStringLiteral("0x%1:").arg(it.key(), 4, 16, QLatin1Char('0'));
+        result += QString::fromLatin1(it.value().toHex());
+    }
+#endif
+    return result;
+}
+
+QString DeviceInfo::getVendor() const
+{
+    // Prefer the advertised company identifier, fall back to the
+    // OUI part of the address which is only meaningful for public ones
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    const QVector<quint16> ids = device.manufacturerIds();
+    if (!ids.isEmpty())
+        return QStringLiteral("0x%1").arg(ids.first(), 4, 16, QLatin1Char('0'));
+#endif
+#ifdef Q_OS_MAC
+    return QString();
+#else
+    if (m_randomAddress)
+        return QString();
+    return device.address().toString().left(8);
+#endif
 }
 
 QBluetoothDeviceInfo DeviceInfo::getDevice()
@@ -78,3 +167,27 @@ void DeviceInfo::setDevice(const QBluetoothDeviceInfo &dev)
     device = QBluetoothDeviceInfo(dev);
     Q_EMIT deviceChanged();
 }
+
+void DeviceInfo::setDevice(const QBluetoothDeviceInfo &dev, const QString &adapter)
+{
+    device = QBluetoothDeviceInfo(dev);
+    // rssi() is 0 when the backend did not report a value
+    if (dev.rssi() != 0)
+        m_adapterRssi.insert(adapter, dev.rssi());
+    Q_EMIT deviceChanged();
+}
+
+void DeviceInfo::setIdentity(const QString &address, const QString &name)
+{
+    if (address == m_identity && name == m_identityName)
+        return;
+
+    m_identity = address;
+    m_identityName = name;
+    Q_EMIT deviceChanged();
+}
+
+void DeviceInfo::setRandomAddress(bool random)
+{
+    m_randomAddress = random;
+}
@@ -46,26 +46,48 @@
 #include <qbluetoothdeviceinfo.h>
 #include <qbluetoothaddress.h>
 #include <QList>
-#include "deviceinfo.h"
+#include <QHash>
+#include <QStringList>
+#include "instancecounter.h"
 
-class DeviceInfo: public QObject
+class DeviceInfo: public QObject, public InstanceCounted<DeviceInfo>
 {
     Q_OBJECT
     Q_PROPERTY(QString deviceName READ getName NOTIFY deviceChanged)
     Q_PROPERTY(QString deviceAddress READ getAddress NOTIFY deviceChanged)
+    Q_PROPERTY(int rssi READ getRssi NOTIFY deviceChanged)
+    Q_PROPERTY(QString adapterRssi READ getAdapterRssi NOTIFY deviceChanged)
 public:
     DeviceInfo();
     DeviceInfo(const QBluetoothDeviceInfo &d);
     QString getAddress() const;
+    static QString addressOf(const QBluetoothDeviceInfo &d);
     QString getName() const;
+    int getRssi() const;
+    QString getAdapterRssi() const;
+    QString bestAdapter() const;
+    QStringList getServiceUuids() const;
+    QString getManufacturerData() const;
+    QString getVendor() const;
     QBluetoothDeviceInfo getDevice();
     void setDevice(const QBluetoothDeviceInfo &dev);
+    void setDevice(const QBluetoothDeviceInfo &dev, const QString &adapter);
+    // identity of a device whose private address was resolved with an IRK,
+    // getAddress() reports it instead of the current private address
+    void setIdentity(const QString &address, const QString &name);
+    // random addresses carry no OUI, getVendor() doesn't derive one from them
+    void setRandomAddress(bool random);
 
 Q_SIGNALS:
     void deviceChanged();
 
 private:
     QBluetoothDeviceInfo device;
+    // last RSSI per local adapter address, empty key for the default adapter
+    QHash<QString, int> m_adapterRssi;
+    QString m_identity;
+    QString m_identityName;
+    bool m_randomAddress;
 };
 
 #endif // DEVICEINFO_H
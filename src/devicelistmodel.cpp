@@ -0,0 +1,425 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "devicelistmodel.h"
+#include "deviceinfo.h"
+#include "presencetracker.h"
+#include <algorithm>
+
+DeviceListModel::DeviceListModel(PresenceTracker *presence, QObject *parent):
+    QAbstractListModel(parent), m_presence(presence)
+{
+}
+
+int DeviceListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_devices.size();
+}
+
+QVariant DeviceListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_devices.size())
+        return QVariant();
+
+    DeviceInfo *d = m_devices.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return d->getName();
+    case DeviceRole:
+        return QVariant::fromValue<QObject*>(d);
+    case AddressRole:
+        return d->getAddress();
+    case RssiRole:
+        return d->getRssi();
+    case AdapterRssiRole:
+        return d->getAdapterRssi();
+    case LastSeenRole:
+        return m_presence->lastSeen(d->getAddress());
+    case VendorRole:
+        return d->getVendor();
+    case ServiceRole: {
+        const QStringList uuids = d->getServiceUuids();
+        return uuids.isEmpty() ? QString() : uuids.first();
+    }
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> DeviceListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles.insert(DeviceRole, "device");
+    roles.insert(NameRole, "deviceName");
+    roles.insert(AddressRole, "deviceAddress");
+    roles.insert(RssiRole, "rssi");
+    roles.insert(AdapterRssiRole, "adapterRssi");
+    roles.insert(LastSeenRole, "lastSeen");
+    roles.insert(VendorRole, "vendor");
+    roles.insert(ServiceRole, "service");
+    return roles;
+}
+
+DeviceInfo *DeviceListModel::device(int row) const
+{
+    return m_devices.value(row);
+}
+
+void DeviceListModel::append(DeviceInfo *device)
+{
+    const int row = m_devices.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_devices.append(device);
+    m_rows.insert(device, row);
+    endInsertRows();
+}
+
+void DeviceListModel::remove(DeviceInfo *device)
+{
+    const int row = m_rows.value(device, -1);
+    if (row < 0)
+        return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_devices.removeAt(row);
+    m_rows.remove(device);
+    for (int i = row; i < m_devices.size(); i++)
+        m_rows[m_devices.at(i)] = i;
+    endRemoveRows();
+}
+
+void DeviceListModel::deviceChanged(DeviceInfo *device)
+{
+    const int row = m_rows.value(device, -1);
+    if (row < 0)
+        return;
+
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed);
+}
+
+SortedDeviceModel::SortedDeviceModel(DeviceListModel *source, QObject *parent):
+    QAbstractProxyModel(parent), m_source(source), m_sortMode(SortByRssi),
+    m_groupMode(NoGrouping)
+{
+    setSourceModel(source);
+    connect(source, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            this, SLOT(sourceRowsInserted(QModelIndex,int,int)));
+    connect(source, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+            this, SLOT(sourceRowsAboutToBeRemoved(QModelIndex,int,int)));
+    connect(source, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+            this, SLOT(sourceRowsRemoved(QModelIndex,int,int)));
+    connect(source, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+            this, SLOT(sourceDataChanged(QModelIndex,QModelIndex)));
+    connect(source, SIGNAL(modelReset()), this, SLOT(resort()));
+    resort();
+}
+
+SortedDeviceModel::SortMode SortedDeviceModel::sortMode() const
+{
+    return m_sortMode;
+}
+
+void SortedDeviceModel::setSortMode(SortMode mode)
+{
+    if (mode == m_sortMode)
+        return;
+
+    m_sortMode = mode;
+    resort();
+    emit sortModeChanged();
+}
+
+SortedDeviceModel::GroupMode SortedDeviceModel::groupMode() const
+{
+    return m_groupMode;
+}
+
+void SortedDeviceModel::setGroupMode(GroupMode mode)
+{
+    if (mode == m_groupMode)
+        return;
+
+    m_groupMode = mode;
+    resort();
+    emit groupModeChanged();
+}
+
+QModelIndex SortedDeviceModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || column != 0 || row < 0 || row >= m_proxyToSource.size())
+        return QModelIndex();
+    return createIndex(row, column);
+}
+
+QModelIndex SortedDeviceModel::parent(const QModelIndex &) const
+{
+    return QModelIndex();
+}
+
+int SortedDeviceModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_proxyToSource.size();
+}
+
+int SortedDeviceModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return 1;
+}
+
+QModelIndex SortedDeviceModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || proxyIndex.row() >= m_proxyToSource.size())
+        return QModelIndex();
+    return m_source->index(m_proxyToSource.at(proxyIndex.row()));
+}
+
+QModelIndex SortedDeviceModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid() || sourceIndex.row() >= m_sourceToProxy.size())
+        return QModelIndex();
+    return index(m_sourceToProxy.at(sourceIndex.row()), 0);
+}
+
+QVariant SortedDeviceModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_proxyToSource.size())
+        return QVariant();
+
+    if (role == SectionRole)
+        return m_keys.at(m_proxyToSource.at(index.row())).group;
+    return m_source->data(mapToSource(index), role);
+}
+
+QHash<int, QByteArray> SortedDeviceModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = m_source->roleNames();
+    roles.insert(SectionRole, "section");
+    return roles;
+}
+
+void SortedDeviceModel::sourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    const int count = last - first + 1;
+    for (int i = 0; i < m_proxyToSource.size(); i++) {
+        if (m_proxyToSource.at(i) >= first)
+            m_proxyToSource[i] += count;
+    }
+    m_keys.insert(first, count, Key());
+    m_sourceToProxy.insert(first, count, -1);
+
+    for (int row = first; row <= last; row++) {
+        m_keys[row] = keyFor(row);
+        const int position = insertPosition(row);
+        beginInsertRows(QModelIndex(), position, position);
+        m_proxyToSource.insert(position, row);
+        remap(position, m_proxyToSource.size() - 1);
+        endInsertRows();
+    }
+}
+
+void SortedDeviceModel::sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    for (int row = first; row <= last; row++) {
+        const int position = m_sourceToProxy.at(row);
+        beginRemoveRows(QModelIndex(), position, position);
+        m_proxyToSource.remove(position);
+        remap(position, m_proxyToSource.size() - 1);
+        endRemoveRows();
+    }
+}
+
+void SortedDeviceModel::sourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    // only the source numbering changes, the proxy order stays the same
+    const int count = last - first + 1;
+    m_keys.remove(first, count);
+    m_sourceToProxy.remove(first, count);
+    for (int i = 0; i < m_proxyToSource.size(); i++) {
+        if (m_proxyToSource.at(i) > last)
+            m_proxyToSource[i] -= count;
+        m_sourceToProxy[m_proxyToSource.at(i)] = i;
+    }
+}
+
+void SortedDeviceModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++)
+        updateRow(row);
+}
+
+void SortedDeviceModel::resort()
+{
+    beginResetModel();
+    const int count = m_source->rowCount();
+    m_keys.resize(count);
+    m_proxyToSource.resize(count);
+    m_sourceToProxy.resize(count);
+    for (int row = 0; row < count; row++) {
+        m_keys[row] = keyFor(row);
+        m_proxyToSource[row] = row;
+    }
+    std::stable_sort(m_proxyToSource.begin(), m_proxyToSource.end(),
+                     [this](int a, int b) { return lessThan(a, b); });
+    remap(0, count - 1);
+    endResetModel();
+}
+
+SortedDeviceModel::Key SortedDeviceModel::keyFor(int sourceRow) const
+{
+    const DeviceInfo *d = m_source->device(sourceRow);
+    const QModelIndex source = m_source->index(sourceRow);
+    Key key;
+    key.number = 0;
+
+    switch (m_groupMode) {
+    case NoGrouping:
+        break;
+    case GroupByManufacturer:
+        key.group = d->getVendor();
+        if (key.group.isEmpty())
+            key.group = QStringLiteral("Unknown manufacturer");
+        break;
+    case GroupByService:
+        key.group = source.data(DeviceListModel::ServiceRole).toString();
+        if (key.group.isEmpty())
+            key.group = QStringLiteral("No advertised service");
+        break;
+    }
+
+    // numbers are negated so that the ascending order shows the
+    // strongest and most recently seen devices first
+    switch (m_sortMode) {
+    case SortByRssi:
+        key.number = -d->getRssi();
+        key.text = d->getName().toLower();
+        break;
+    case SortByName:
+        key.text = d->getName().toLower() + QLatin1Char('\n') + d->getAddress();
+        break;
+    case SortByLastSeen:
+        key.number = -source.data(DeviceListModel::LastSeenRole).toLongLong();
+        key.text = d->getAddress();
+        break;
+    case SortByVendor:
+        key.text = d->getVendor() + QLatin1Char('\n') + d->getName().toLower();
+        break;
+    }
+    return key;
+}
+
+bool SortedDeviceModel::lessThan(int sourceA, int sourceB) const
+{
+    const Key &a = m_keys.at(sourceA);
+    const Key &b = m_keys.at(sourceB);
+    int cmp = a.group.compare(b.group);
+    if (cmp)
+        return cmp < 0;
+    if (a.number != b.number)
+        return a.number < b.number;
+    cmp = a.text.compare(b.text);
+    if (cmp)
+        return cmp < 0;
+    return sourceA < sourceB;
+}
+
+int SortedDeviceModel::insertPosition(int sourceRow) const
+{
+    return std::upper_bound(m_proxyToSource.constBegin(), m_proxyToSource.constEnd(), sourceRow,
+                            [this](int a, int b) { return lessThan(a, b); })
+            - m_proxyToSource.constBegin();
+}
+
+void SortedDeviceModel::updateRow(int sourceRow)
+{
+    m_keys[sourceRow] = keyFor(sourceRow);
+    const int position = m_sourceToProxy.at(sourceRow);
+    const int last = m_proxyToSource.size() - 1;
+
+    const bool afterPrevious = position == 0
+            || lessThan(m_proxyToSource.at(position - 1), sourceRow);
+    const bool beforeNext = position == last
+            || lessThan(sourceRow, m_proxyToSource.at(position + 1));
+    if (afterPrevious && beforeNext) {
+        const QModelIndex changed = index(position, 0);
+        emit dataChanged(changed, changed);
+        return;
+    }
+
+    // Both halves around the changed row are still sorted, so a binary
+    // search in the half the row moves into finds its new place.
+    QVector<int>::const_iterator begin = m_proxyToSource.constBegin();
+    int destination;
+    if (!afterPrevious) {
+        destination = std::upper_bound(begin, begin + position, sourceRow,
+                                       [this](int a, int b) { return lessThan(a, b); }) - begin;
+    } else {
+        destination = std::upper_bound(begin + position + 1, m_proxyToSource.constEnd(), sourceRow,
+                                       [this](int a, int b) { return lessThan(a, b); }) - begin;
+    }
+
+    beginMoveRows(QModelIndex(), position, position, QModelIndex(), destination);
+    m_proxyToSource.remove(position);
+    const int target = destination > position ? destination - 1 : destination;
+    m_proxyToSource.insert(target, sourceRow);
+    remap(qMin(position, target), qMax(position, target));
+    endMoveRows();
+
+    const QModelIndex changed = index(target, 0);
+    emit dataChanged(changed, changed);
+}
+
+void SortedDeviceModel::remap(int fromProxyRow, int toProxyRow)
+{
+    for (int i = fromProxyRow; i <= toProxyRow; i++)
+        m_sourceToProxy[m_proxyToSource.at(i)] = i;
+}
@@ -0,0 +1,147 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef DEVICELISTMODEL_H
+#define DEVICELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QAbstractProxyModel>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+class DeviceInfo;
+class PresenceTracker;
+
+// Devices in discovery order. Device feeds it with row inserts, removals
+// and per-row updates instead of resetting the whole list.
+class DeviceListModel: public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    enum Roles {
+        DeviceRole = Qt::UserRole + 1,
+        NameRole,
+        AddressRole,
+        RssiRole,
+        AdapterRssiRole,
+        LastSeenRole,
+        VendorRole,
+        ServiceRole
+    };
+
+    explicit DeviceListModel(PresenceTracker *presence, QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    QHash<int, QByteArray> roleNames() const;
+
+    DeviceInfo *device(int row) const;
+    void append(DeviceInfo *device);
+    void remove(DeviceInfo *device);
+    void deviceChanged(DeviceInfo *device);
+
+private:
+    PresenceTracker *m_presence;
+    QList<DeviceInfo*> m_devices;
+    QHash<DeviceInfo*, int> m_rows;
+};
+
+// Sorted and optionally grouped view of a DeviceListModel. A changed
+// source row is moved to its new place with a binary search instead of
+// re-sorting, which keeps constant RSSI updates cheap.
+class SortedDeviceModel: public QAbstractProxyModel
+{
+    Q_OBJECT
+    Q_ENUMS(SortMode GroupMode)
+    Q_PROPERTY(SortMode sortMode READ sortMode WRITE setSortMode NOTIFY sortModeChanged)
+    Q_PROPERTY(GroupMode groupMode READ groupMode WRITE setGroupMode NOTIFY groupModeChanged)
+public:
+    enum SortMode { SortByRssi, SortByName, SortByLastSeen, SortByVendor };
+    enum GroupMode { NoGrouping, GroupByManufacturer, GroupByService };
+    enum Roles { SectionRole = Qt::UserRole + 100 };
+
+    explicit SortedDeviceModel(DeviceListModel *source, QObject *parent = 0);
+
+    SortMode sortMode() const;
+    void setSortMode(SortMode mode);
+    GroupMode groupMode() const;
+    void setGroupMode(GroupMode mode);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &child) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    QHash<int, QByteArray> roleNames() const;
+
+Q_SIGNALS:
+    void sortModeChanged();
+    void groupModeChanged();
+
+private slots:
+    void sourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void sourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void resort();
+
+private:
+    struct Key
+    {
+        QString group;
+        QString text;
+        qint64 number;
+    };
+
+    Key keyFor(int sourceRow) const;
+    bool lessThan(int sourceA, int sourceB) const;
+    int insertPosition(int sourceRow) const;
+    void updateRow(int sourceRow);
+    void remap(int fromProxyRow, int toProxyRow);
+
+    DeviceListModel *m_source;
+    SortMode m_sortMode;
+    GroupMode m_groupMode;
+    QVector<Key> m_keys;
+    QVector<int> m_proxyToSource;
+    QVector<int> m_sourceToProxy;
+};
+
+#endif // DEVICELISTMODEL_H
@@ -0,0 +1,205 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "devicesearchindex.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+const int gramSize = 3;
+// the index is rebuilt once this many documents and at least a quarter
+// of all of them are dead
+const int minDeadForCompaction = 64;
+}
+
+DeviceSearchIndex::DeviceSearchIndex():
+    m_dead(0)
+{
+}
+
+bool DeviceSearchIndex::update(const QString &key, const QString &name,
+                               const QString &address, const QStringList &uuids)
+{
+    // fields are separated by newlines which never occur in a query, so
+    // grams spanning two fields can not produce a match
+    QString text = name.toLower();
+    text += QLatin1Char('\n');
+    text += address.toLower();
+    text += QLatin1Char('\n');
+    text += address.toLower().remove(QLatin1Char(':'));
+    foreach (const QString &uuid, uuids) {
+        text += QLatin1Char('\n');
+        text += uuid.toLower();
+    }
+
+    int id = m_ids.value(key, -1);
+    if (id < 0) {
+        id = m_documents.size();
+        Document document;
+        document.key = key;
+        document.alive = true;
+        m_documents.append(document);
+        m_ids.insert(key, id);
+    } else if (m_documents.at(id).alive && m_documents.at(id).text == text) {
+        return false;
+    }
+
+    // postings of grams the old text had are left in place, search()
+    // verifies every candidate against the current text anyway
+    Document &document = m_documents[id];
+    document.text = text;
+    document.alive = true;
+    for (int i = 0; i + gramSize <= text.size(); i++)
+        addPosting(gram(text.constData() + i), id);
+    return true;
+}
+
+void DeviceSearchIndex::remove(const QString &key)
+{
+    QHash<QString, int>::iterator it = m_ids.find(key);
+    if (it == m_ids.end())
+        return;
+    const int id = it.value();
+    m_ids.erase(it);
+
+    // the key comes back under a new id if the device returns
+    Document &document = m_documents[id];
+    document.alive = false;
+    document.key.clear();
+    document.text.clear();
+    m_dead++;
+    if (m_dead >= minDeadForCompaction && m_dead * 4 >= m_documents.size())
+        compact();
+}
+
+void DeviceSearchIndex::compact()
+{
+    // renumbering keeps the order of the live documents, the postings
+    // are rebuilt from scratch which also drops grams of old texts
+    QVector<Document> documents;
+    documents.reserve(m_documents.size() - m_dead);
+    foreach (const Document &document, m_documents) {
+        if (document.alive)
+            documents.append(document);
+    }
+    m_documents.swap(documents);
+    m_ids.clear();
+    m_postings.clear();
+    m_dead = 0;
+
+    for (int id = 0; id < m_documents.size(); id++) {
+        const Document &document = m_documents.at(id);
+        m_ids.insert(document.key, id);
+        for (int i = 0; i + gramSize <= document.text.size(); i++)
+            addPosting(gram(document.text.constData() + i), id);
+    }
+}
+
+void DeviceSearchIndex::clear()
+{
+    m_documents.clear();
+    m_ids.clear();
+    m_postings.clear();
+    m_dead = 0;
+}
+
+QStringList DeviceSearchIndex::search(const QString &query, int limit) const
+{
+    QStringList result;
+    const QString q = query.toLower();
+    if (q.isEmpty())
+        return result;
+
+    if (q.size() < gramSize) {
+        // too short for the index, a linear scan stops at the limit
+        for (int id = 0; id < m_documents.size() && result.size() < limit; id++) {
+            const Document &document = m_documents.at(id);
+            if (document.alive && document.text.contains(q))
+                result.append(document.key);
+        }
+        return result;
+    }
+
+    QVector<const QVector<int>*> lists;
+    for (int i = 0; i + gramSize <= q.size(); i++) {
+        QHash<quint64, QVector<int> >::const_iterator it = m_postings.constFind(gram(q.constData() + i));
+        if (it == m_postings.constEnd())
+            return result;
+        lists.append(&it.value());
+    }
+
+    // intersect starting from the rarest gram to keep candidates small
+    std::sort(lists.begin(), lists.end(),
+              [](const QVector<int> *a, const QVector<int> *b) { return a->size() < b->size(); });
+    QVector<int> candidates = *lists.first();
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); i++) {
+        QVector<int> next;
+        std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+                              lists.at(i)->constBegin(), lists.at(i)->constEnd(),
+                              std::back_inserter(next));
+        candidates.swap(next);
+    }
+
+    foreach (int id, candidates) {
+        const Document &document = m_documents.at(id);
+        if (document.alive && document.text.contains(q)) {
+            result.append(document.key);
+            if (result.size() >= limit)
+                break;
+        }
+    }
+    return result;
+}
+
+quint64 DeviceSearchIndex::gram(const QChar *c)
+{
+    return (quint64(c[0].unicode()) << 32) | (quint64(c[1].unicode()) << 16) | c[2].unicode();
+}
+
+void DeviceSearchIndex::addPosting(quint64 gram, int id)
+{
+    QVector<int> &ids = m_postings[gram];
+    if (ids.isEmpty() || ids.last() < id) {
+        ids.append(id);
+        return;
+    }
+
+    // an older document was updated, keep the list sorted and unique
+    QVector<int>::iterator it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id)
+        ids.insert(it, id);
+}
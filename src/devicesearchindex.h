@@ -0,0 +1,86 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef DEVICESEARCHINDEX_H
+#define DEVICESEARCHINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Trigram index over device names, addresses and advertised service
+// UUIDs. Documents are added or updated in place and removal only marks
+// them dead, so queries stay fast over the thousands of devices seen in a
+// long session. Once dead documents make up a good part of the index it
+// is rebuilt without them, which keeps rotating private addresses from
+// growing it for the whole session.
+class DeviceSearchIndex
+{
+public:
+    DeviceSearchIndex();
+
+    // key is the device address, the other fields are what is searched;
+    // returns false if the document did not change
+    bool update(const QString &key, const QString &name,
+                const QString &address, const QStringList &uuids);
+    void remove(const QString &key);
+    void clear();
+
+    // keys of the live documents containing query, case insensitive
+    QStringList search(const QString &query, int limit) const;
+
+private:
+    struct Document
+    {
+        QString key;
+        QString text;
+        bool alive;
+    };
+
+    static quint64 gram(const QChar *c);
+    void addPosting(quint64 gram, int id);
+    void compact();
+
+    QVector<Document> m_documents;
+    QHash<QString, int> m_ids;
+    // sorted document ids per trigram
+    QHash<quint64, QVector<int> > m_postings;
+    int m_dead;
+};
+
+#endif // DEVICESEARCHINDEX_H
@@ -0,0 +1,181 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "discoveryworker.h"
+#include "deviceinfo.h"
+#include <qbluetoothaddress.h>
+#include <qbluetoothlocaldevice.h>
+#include <qbluetoothhostinfo.h>
+#include <QDateTime>
+#include <QStringList>
+
+DiscoveryWorker::DiscoveryWorker(DiscoveryQueue *queue):
+    m_queue(queue), m_anyFinished(false), m_addressTypes(this)
+{
+    // m_addressTypes is parented so that it moves to the worker thread
+    // and receives the BlueZ signals there
+}
+
+int DiscoveryWorker::droppedRecords() const
+{
+    return m_dropped.load();
+}
+
+void DiscoveryWorker::start()
+{
+    // agents are created on first use to keep startup short
+    if (m_agents.isEmpty())
+        createAgents();
+
+    m_anyFinished = false;
+    foreach (QBluetoothDeviceDiscoveryAgent *agent, m_agents) {
+        if (agent->isActive())
+            continue;
+        //! [les-devicediscovery-2]
+        agent->start();
+        //! [les-devicediscovery-2]
+        if (agent->isActive())
+            m_activeAgents.insert(agent);
+    }
+
+    if (m_activeAgents.isEmpty())
+        emit scanStopped(true);
+}
+
+void DiscoveryWorker::stop()
+{
+    // finishing is reported through canceled() -> agentFinished()
+    foreach (QBluetoothDeviceDiscoveryAgent *agent, m_agents) {
+        if (agent->isActive())
+            agent->stop();
+    }
+}
+
+void DiscoveryWorker::setAdapter(const QString &adapter)
+{
+    m_adapter = adapter;
+    if (!m_agents.isEmpty())
+        createAgents();
+}
+
+void DiscoveryWorker::createAgents()
+{
+    const bool wasActive = !m_activeAgents.isEmpty();
+    foreach (QBluetoothDeviceDiscoveryAgent *agent, m_agents)
+        agent->disconnect(this);
+    qDeleteAll(m_agents);
+    m_agents.clear();
+    m_agentAdapters.clear();
+    m_activeAgents.clear();
+
+    QStringList adapters;
+    if (m_adapter == QLatin1String("all")) {
+        foreach (const QBluetoothHostInfo &host, QBluetoothLocalDevice::allDevices())
+            adapters.append(host.address().toString());
+    } else {
+        adapters.append(m_adapter);
+    }
+
+    foreach (const QString &adapter, adapters) {
+        //! [les-devicediscovery-1]
+        QBluetoothDeviceDiscoveryAgent *agent;
+        if (adapter.isEmpty())
+            agent = new QBluetoothDeviceDiscoveryAgent(this);
+        else
+            agent = new QBluetoothDeviceDiscoveryAgent(QBluetoothAddress(adapter), this);
+        //agent->setLowEnergyDiscoveryTimeout(5000);
+        connect(agent, SIGNAL(deviceDiscovered(const QBluetoothDeviceInfo&)),
+                this, SLOT(addDevice(const QBluetoothDeviceInfo&)));
+        connect(agent, SIGNAL(error(QBluetoothDeviceDiscoveryAgent::Error)),
+                this, SLOT(agentError(QBluetoothDeviceDiscoveryAgent::Error)));
+        connect(agent, SIGNAL(finished()), this, SLOT(agentFinished()));
+        connect(agent, SIGNAL(canceled()), this, SLOT(agentFinished()));
+        //! [les-devicediscovery-1]
+        m_agents.append(agent);
+        m_agentAdapters.insert(agent, adapter);
+    }
+
+    if (wasActive)
+        emit scanStopped(false);
+}
+
+//! [les-devicediscovery-3]
+void DiscoveryWorker::addDevice(const QBluetoothDeviceInfo &info)
+{
+    if (!(info.coreConfigurations() & QBluetoothDeviceInfo::LowEnergyCoreConfiguration))
+        return;
+
+    DiscoveryRecord record;
+    record.info = info;
+    record.address = DeviceInfo::addressOf(info);
+    record.adapter = m_agentAdapters.value(sender());
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.addressType = m_addressTypes.lookup(record.address);
+
+    const bool wasEmpty = m_queue->isEmpty();
+    if (!m_queue->push(record)) {
+        // the GUI is behind, losing a repeated advertisement is harmless
+        m_dropped.ref();
+        return;
+    }
+    if (wasEmpty)
+        emit recordsAvailable();
+}
+//! [les-devicediscovery-3]
+
+void DiscoveryWorker::agentFinished()
+{
+    m_anyFinished = true;
+    agentDone(sender(), false);
+}
+
+void DiscoveryWorker::agentError(QBluetoothDeviceDiscoveryAgent::Error error)
+{
+    emit scanError(int(error));
+    // an agent which failed does not report finished() anymore
+    agentDone(sender(), true);
+}
+
+void DiscoveryWorker::agentDone(QObject *agent, bool failed)
+{
+    // an agent failing synchronously in start() was never counted
+    if (!m_activeAgents.remove(agent))
+        return;
+
+    if (m_activeAgents.isEmpty())
+        emit scanStopped(failed && !m_anyFinished);
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef DISCOVERYWORKER_H
+#define DISCOVERYWORKER_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QBluetoothDeviceDiscoveryAgent>
+#include <QBluetoothDeviceInfo>
+#include "spscqueue.h"
+#include "bluezaddresstypes.h"
+
+// One advertisement as handed from the worker thread to the GUI thread.
+struct DiscoveryRecord
+{
+    QBluetoothDeviceInfo info;
+    QString address;
+    QString adapter;
+    qint64 timestamp;
+    // as reported by BlueZ, Unknown on other backends
+    BluezAddressTypes::AddressType addressType;
+};
+
+typedef SpscQueue<DiscoveryRecord> DiscoveryQueue;
+
+// Owns the discovery agents and runs on its own thread. Low Energy
+// results are filtered and pushed into a DiscoveryQueue which the GUI
+// thread drains, so scanning never competes with QML rendering.
+class DiscoveryWorker: public QObject
+{
+    Q_OBJECT
+public:
+    explicit DiscoveryWorker(DiscoveryQueue *queue);
+    int droppedRecords() const;
+
+public slots:
+    void start();
+    void stop();
+    void setAdapter(const QString &adapter);
+
+Q_SIGNALS:
+    // emitted when the queue receives data after having been drained
+    void recordsAvailable();
+    void scanError(int error);
+    // all agents are done, failed is set if none of them finished normally
+    void scanStopped(bool failed);
+
+private slots:
+    void addDevice(const QBluetoothDeviceInfo&);
+    void agentFinished();
+    void agentError(QBluetoothDeviceDiscoveryAgent::Error);
+
+private:
+    void createAgents();
+    void agentDone(QObject *agent, bool failed);
+
+    DiscoveryQueue *m_queue;
+    QList<QBluetoothDeviceDiscoveryAgent*> m_agents;
+    QHash<QObject*, QString> m_agentAdapters;
+    QString m_adapter;
+    // agents whose start() succeeded and which have not reported back
+    QSet<QObject*> m_activeAgents;
+    bool m_anyFinished;
+    QAtomicInt m_dropped;
+    BluezAddressTypes m_addressTypes;
+};
+
+#endif // DISCOVERYWORKER_H
@@ -0,0 +1,521 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "fleetaudit.h"
+#include "streamwriter.h"
+#include "device.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+AuditJob::AuditJob(const QBluetoothDeviceInfo &info, const QString &adapter,
+                   bool randomAddress, int timeout, QObject *parent):
+    QObject(parent), m_info(info), m_adapter(adapter), m_randomAddress(randomAddress),
+    m_retried(false), m_controller(0), m_finished(false)
+{
+    m_result.address = info.address().toString();
+    m_result.name = info.name();
+    m_result.adapter = adapter;
+    m_result.connectTime = -1;
+    m_result.discoveryTime = -1;
+    m_result.detailsTime = -1;
+    m_result.totalTime = -1;
+
+    createController();
+
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(timeout);
+    connect(&m_timeout, SIGNAL(timeout()), this, SLOT(timedOut()));
+}
+
+AuditJob::~AuditJob()
+{
+    qDeleteAll(m_services);
+}
+
+void AuditJob::start()
+{
+    m_clock.start();
+    m_timeout.start();
+    m_controller->connectToDevice();
+}
+
+void AuditJob::createController()
+{
+    if (m_adapter.isEmpty())
+        m_controller = new QLowEnergyController(m_info, this);
+    else
+        m_controller = new QLowEnergyController(m_info.address(), QBluetoothAddress(m_adapter), this);
+    m_controller->setRemoteAddressType(m_randomAddress ? QLowEnergyController::RandomAddress
+                                                       : QLowEnergyController::PublicAddress);
+
+    connect(m_controller, SIGNAL(connected()), this, SLOT(connected()));
+    connect(m_controller, SIGNAL(discoveryFinished()), this, SLOT(discoveryFinished()));
+    connect(m_controller, SIGNAL(error(QLowEnergyController::Error)),
+            this, SLOT(controllerError(QLowEnergyController::Error)));
+    connect(m_controller, SIGNAL(disconnected()), this, SLOT(disconnected()));
+}
+
+bool AuditJob::retryConnect()
+{
+    if (m_finished || m_retried || m_result.connectTime >= 0)
+        return false;
+
+    // the address type cannot be changed on a controller which is
+    // connecting, the retry goes through a fresh one
+    m_retried = true;
+    m_controller->disconnect(this);
+    m_controller->disconnectFromDevice();
+    m_controller->deleteLater();
+    m_randomAddress = !m_randomAddress;
+    createController();
+
+    qWarning() << "Audit retrying" << m_result.address << "as"
+               << (m_randomAddress ? "random" : "public");
+    m_timeout.start();
+    m_controller->connectToDevice();
+    return true;
+}
+
+void AuditJob::abort()
+{
+    fail(QStringLiteral("Cancelled"));
+}
+
+const AuditResult &AuditJob::result() const
+{
+    return m_result;
+}
+
+int AuditJob::serviceObjects() const
+{
+    return m_services.size();
+}
+
+int AuditJob::lowEnergyServices() const
+{
+    int count = m_controller->findChildren<QLowEnergyService*>().size();
+    foreach (const ServiceInfo *info, m_services)
+        count += info->findChildren<QLowEnergyService*>().size();
+    return count;
+}
+
+void AuditJob::connected()
+{
+    m_result.connectTime = m_clock.elapsed();
+    m_controller->discoverServices();
+}
+
+void AuditJob::discoveryFinished()
+{
+    m_result.discoveryTime = m_clock.elapsed();
+
+    foreach (const QBluetoothUuid &uuid, m_controller->services()) {
+        QLowEnergyService *service = m_controller->createServiceObject(uuid);
+        if (!service)
+            continue;
+
+        m_services.append(new ServiceInfo(service));
+        m_pending.insert(service);
+        connect(service, SIGNAL(stateChanged(QLowEnergyService::ServiceState)),
+                this, SLOT(serviceStateChanged(QLowEnergyService::ServiceState)));
+        connect(service, SIGNAL(error(QLowEnergyService::ServiceError)),
+                this, SLOT(serviceError(QLowEnergyService::ServiceError)));
+    }
+
+    // start the detail discovery only after every service object exists,
+    // a cached service may report ServiceDiscovered synchronously
+    foreach (ServiceInfo *info, m_services)
+        info->service()->discoverDetails();
+
+    if (m_pending.isEmpty())
+        collect();
+}
+
+void AuditJob::serviceStateChanged(QLowEnergyService::ServiceState state)
+{
+    if (state == QLowEnergyService::ServiceDiscovered)
+        serviceDone(qobject_cast<QLowEnergyService*>(sender()));
+}
+
+void AuditJob::serviceError(QLowEnergyService::ServiceError error)
+{
+    QLowEnergyService *service = qobject_cast<QLowEnergyService*>(sender());
+    qWarning() << "Audit of" << m_result.address << "service error" << error;
+
+    // read errors on single characteristics do not stop the discovery
+    if (service && service->state() != QLowEnergyService::DiscoveringServices)
+        serviceDone(service);
+}
+
+void AuditJob::controllerError(QLowEnergyController::Error error)
+{
+    Q_UNUSED(error);
+    if (retryConnect())
+        return;
+    fail(m_controller->errorString());
+}
+
+void AuditJob::disconnected()
+{
+    if (m_result.detailsTime < 0 && m_result.error.isEmpty())
+        m_result.error = QStringLiteral("Disconnected by the remote device");
+    done();
+}
+
+void AuditJob::timedOut()
+{
+    if (retryConnect())
+        return;
+    fail(QStringLiteral("Timed out"));
+}
+
+void AuditJob::serviceDone(QLowEnergyService *service)
+{
+    if (!m_pending.remove(service) || !m_pending.isEmpty())
+        return;
+
+    collect();
+}
+
+void AuditJob::collect()
+{
+    if (m_result.detailsTime >= 0)
+        return;
+
+    m_result.detailsTime = m_clock.elapsed();
+
+    foreach (ServiceInfo *info, m_services) {
+        AuditService service;
+        service.uuid = info->getUuid();
+        service.name = info->getName();
+        service.complete = info->service()->state() == QLowEnergyService::ServiceDiscovered;
+        foreach (const QLowEnergyCharacteristic &ch, info->service()->characteristics()) {
+            AuditCharacteristic characteristic;
+            characteristic.uuid = CharacteristicInfo::uuidOf(ch);
+            characteristic.name = CharacteristicInfo::nameOf(ch);
+            characteristic.properties = CharacteristicInfo::propertyNames(ch.properties())
+                    .join(QLatin1Char(' '));
+            characteristic.value = QString::fromLatin1(ch.value().toHex());
+            service.characteristics.append(characteristic);
+        }
+        m_result.services.append(service);
+    }
+
+    disconnectFromDevice();
+}
+
+void AuditJob::fail(const QString &reason)
+{
+    if (m_finished)
+        return;
+
+    if (m_result.error.isEmpty())
+        m_result.error = reason;
+
+    // don't wait for a clean disconnect, the controller goes away with the job
+    if (m_controller->state() != QLowEnergyController::UnconnectedState)
+        m_controller->disconnectFromDevice();
+    done();
+}
+
+void AuditJob::disconnectFromDevice()
+{
+    if (m_controller->state() == QLowEnergyController::UnconnectedState)
+        done();
+    else
+        m_controller->disconnectFromDevice();
+}
+
+void AuditJob::done()
+{
+    if (m_finished)
+        return;
+
+    m_finished = true;
+    m_timeout.stop();
+    m_result.totalTime = m_clock.elapsed();
+    emit finished();
+}
+
+FleetAudit::FleetAudit(Device *device, QObject *parent):
+    QObject(parent), m_device(device), m_parallelism(4), m_deviceTimeout(30000),
+    m_total(0), m_failed(0)
+{
+}
+
+bool FleetAudit::running() const
+{
+    return !m_jobs.isEmpty() || !m_queue.isEmpty();
+}
+
+int FleetAudit::parallelism() const
+{
+    return m_parallelism;
+}
+
+void FleetAudit::setParallelism(int parallelism)
+{
+    parallelism = qMax(1, parallelism);
+    if (parallelism == m_parallelism)
+        return;
+
+    m_parallelism = parallelism;
+    emit parallelismChanged();
+    launchJobs();
+}
+
+int FleetAudit::deviceTimeout() const
+{
+    return m_deviceTimeout;
+}
+
+void FleetAudit::setDeviceTimeout(int timeout)
+{
+    if (timeout == m_deviceTimeout)
+        return;
+
+    m_deviceTimeout = timeout;
+    emit deviceTimeoutChanged();
+}
+
+int FleetAudit::total() const
+{
+    return m_total;
+}
+
+int FleetAudit::completed() const
+{
+    return m_results.size();
+}
+
+int FleetAudit::failed() const
+{
+    return m_failed;
+}
+
+QString FleetAudit::lastReport() const
+{
+    return m_lastReport;
+}
+
+int FleetAudit::serviceObjects() const
+{
+    int count = 0;
+    foreach (const AuditJob *job, m_jobs)
+        count += job->serviceObjects();
+    return count;
+}
+
+int FleetAudit::lowEnergyServices() const
+{
+    int count = 0;
+    foreach (const AuditJob *job, m_jobs)
+        count += job->lowEnergyServices();
+    return count;
+}
+
+QString FleetAudit::start(const QString &query)
+{
+    if (running())
+        return QStringLiteral("Audit already running");
+
+    // the same devices the search box lists, UUID and colon-less address
+    // matches included
+    m_results.clear();
+    m_failed = 0;
+    foreach (DeviceInfo *d, m_device->matchingDevices(query)) {
+        Target target;
+        target.info = d->getDevice();
+        target.adapter = d->bestAdapter();
+        target.randomAddress = m_device->addressTypeFor(d->getAddress());
+        m_queue.append(target);
+    }
+
+    m_total = m_queue.size();
+    emit progressChanged();
+    if (m_queue.isEmpty())
+        return QStringLiteral("No devices match the search");
+
+    // connecting while scanning slows down both on most controllers
+    m_device->stopDeviceDiscovery();
+
+    m_started = QDateTime::currentDateTime();
+    m_clock.start();
+    emit runningChanged();
+    launchJobs();
+    return QString("Auditing %1 devices").arg(m_total);
+}
+
+void FleetAudit::cancel()
+{
+    m_queue.clear();
+    foreach (AuditJob *job, m_jobs)
+        job->abort();
+}
+
+void FleetAudit::launchJobs()
+{
+    while (m_jobs.size() < m_parallelism && !m_queue.isEmpty()) {
+        const Target target = m_queue.takeFirst();
+        AuditJob *job = new AuditJob(target.info, target.adapter, target.randomAddress,
+                                     m_deviceTimeout, this);
+        connect(job, SIGNAL(finished()), this, SLOT(jobFinished()));
+        m_jobs.append(job);
+        job->start();
+    }
+}
+
+void FleetAudit::jobFinished()
+{
+    AuditJob *job = qobject_cast<AuditJob*>(sender());
+    if (!job || !m_jobs.removeOne(job))
+        return;
+
+    const AuditResult &result = job->result();
+    if (!result.error.isEmpty()) {
+        qWarning() << "Audit of" << result.address << "failed:" << result.error;
+        ++m_failed;
+    }
+    m_results.append(result);
+    job->deleteLater();
+    emit progressChanged();
+
+    launchJobs();
+    if (running())
+        return;
+
+    qInfo() << "Audited" << m_results.size() << "devices in" << m_clock.elapsed() << "ms,"
+            << m_failed << "failed";
+    const QString message = writeReport();
+    emit runningChanged();
+    emit finished(message);
+}
+
+QString FleetAudit::writeReport()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    QDir().mkpath(dir);
+
+    const QString stamp = m_started.toString("yyyyMMdd-hhmmss");
+    QFile file(QString("%1/ble_scanner-audit-%2.json").arg(dir, stamp));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return QString("Audit report failed: %1").arg(file.errorString());
+
+    JsonWriter writer(&file);
+    writer.beginObject();
+    writer.name("started");
+    writer.value(m_started.toString(Qt::ISODate));
+    writer.name("duration");
+    writer.value(m_clock.elapsed());
+    writer.name("parallelism");
+    writer.value(qint64(m_parallelism));
+    writer.name("devices");
+    writer.value(qint64(m_results.size()));
+    writer.name("failed");
+    writer.value(qint64(m_failed));
+    writer.name("results");
+    writer.beginArray();
+    foreach (const AuditResult &result, m_results)
+        writeResult(writer, result);
+    writer.endArray();
+    writer.endObject();
+
+    const bool error = writer.hasError();
+    file.close();
+    if (error || file.error() != QFile::NoError) {
+        qWarning() << "Audit report failed:" << file.fileName() << file.errorString();
+        return QString("Audit report failed: %1").arg(file.errorString());
+    }
+
+    m_lastReport = file.fileName();
+    return QString("Audit report written to %1").arg(m_lastReport);
+}
+
+void FleetAudit::writeResult(JsonWriter &writer, const AuditResult &result)
+{
+    writer.beginObject();
+    writer.name("address");
+    writer.value(result.address);
+    writer.name("name");
+    writer.value(result.name);
+    writer.name("adapter");
+    writer.value(result.adapter);
+    writer.name("error");
+    if (result.error.isEmpty())
+        writer.nullValue();
+    else
+        writer.value(result.error);
+    writer.name("connectTime");
+    writer.value(result.connectTime);
+    writer.name("discoveryTime");
+    writer.value(result.discoveryTime);
+    writer.name("detailsTime");
+    writer.value(result.detailsTime);
+    writer.name("totalTime");
+    writer.value(result.totalTime);
+    writer.name("services");
+    writer.beginArray();
+    foreach (const AuditService &service, result.services) {
+        writer.beginObject();
+        writer.name("uuid");
+        writer.value(service.uuid);
+        writer.name("name");
+        writer.value(service.name);
+        writer.name("complete");
+        writer.value(service.complete);
+        writer.name("characteristics");
+        writer.beginArray();
+        foreach (const AuditCharacteristic &characteristic, service.characteristics) {
+            writer.beginObject();
+            writer.name("uuid");
+            writer.value(characteristic.uuid);
+            writer.name("name");
+            writer.value(characteristic.name);
+            writer.name("properties");
+            writer.value(characteristic.properties);
+            writer.name("value");
+            writer.value(characteristic.value);
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
@@ -0,0 +1,213 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef FLEETAUDIT_H
+#define FLEETAUDIT_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <qbluetoothdeviceinfo.h>
+#include <qlowenergycontroller.h>
+#include <qlowenergyservice.h>
+#include "instancecounter.h"
+
+class Device;
+class JsonWriter;
+class ServiceInfo;
+
+struct AuditCharacteristic
+{
+    QString uuid;
+    QString name;
+    QString properties;
+    QString value;
+};
+
+struct AuditService
+{
+    QString uuid;
+    QString name;
+    bool complete;
+    QList<AuditCharacteristic> characteristics;
+};
+
+struct AuditResult
+{
+    QString address;
+    QString name;
+    QString adapter;
+    QString error;
+    // milliseconds from the start of the job, -1 if the step never finished
+    qint64 connectTime;
+    qint64 discoveryTime;
+    qint64 detailsTime;
+    qint64 totalTime;
+    QList<AuditService> services;
+};
+
+// Connects to one device, discovers every service including its
+// characteristic values and disconnects again. A connection attempt which
+// fails or times out is retried once with the other address type.
+// finished() is emitted exactly once, whether the job succeeded, failed or
+// timed out.
+class AuditJob: public QObject, public InstanceCounted<AuditJob>
+{
+    Q_OBJECT
+public:
+    AuditJob(const QBluetoothDeviceInfo &info, const QString &adapter,
+             bool randomAddress, int timeout, QObject *parent = 0);
+    ~AuditJob();
+
+    void start();
+    void abort();
+    const AuditResult &result() const;
+    // ServiceInfo objects held until the job is deleted
+    int serviceObjects() const;
+    // QLowEnergyService objects reachable from the controller and the
+    // ServiceInfo objects
+    int lowEnergyServices() const;
+
+Q_SIGNALS:
+    void finished();
+
+private slots:
+    void connected();
+    void discoveryFinished();
+    void serviceStateChanged(QLowEnergyService::ServiceState state);
+    void serviceError(QLowEnergyService::ServiceError error);
+    void controllerError(QLowEnergyController::Error error);
+    void disconnected();
+    void timedOut();
+
+private:
+    void createController();
+    bool retryConnect();
+    void serviceDone(QLowEnergyService *service);
+    void collect();
+    void fail(const QString &reason);
+    void disconnectFromDevice();
+    void done();
+
+    QBluetoothDeviceInfo m_info;
+    QString m_adapter;
+    bool m_randomAddress;
+    bool m_retried;
+    QLowEnergyController *m_controller;
+    QSet<QLowEnergyService*> m_pending;
+    QList<ServiceInfo*> m_services;
+    QElapsedTimer m_clock;
+    QTimer m_timeout;
+    AuditResult m_result;
+    bool m_finished;
+};
+
+// Batch connect-and-inventory over all discovered devices matching a
+// search query, with at most parallelism connections in flight. Failed devices
+// are recorded and skipped, a single JSON report is written at the end.
+class FleetAudit: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(int parallelism READ parallelism WRITE setParallelism NOTIFY parallelismChanged)
+    Q_PROPERTY(int deviceTimeout READ deviceTimeout WRITE setDeviceTimeout NOTIFY deviceTimeoutChanged)
+    Q_PROPERTY(int total READ total NOTIFY progressChanged)
+    Q_PROPERTY(int completed READ completed NOTIFY progressChanged)
+    Q_PROPERTY(int failed READ failed NOTIFY progressChanged)
+    Q_PROPERTY(QString lastReport READ lastReport NOTIFY finished)
+public:
+    explicit FleetAudit(Device *device, QObject *parent = 0);
+
+    bool running() const;
+    int parallelism() const;
+    void setParallelism(int parallelism);
+    int deviceTimeout() const;
+    void setDeviceTimeout(int timeout);
+    int total() const;
+    int completed() const;
+    int failed() const;
+    QString lastReport() const;
+    // ServiceInfo and QLowEnergyService objects owned by the running jobs
+    int serviceObjects() const;
+    int lowEnergyServices() const;
+
+    // query selects the devices like the search box does, an empty
+    // query audits every discovered device. The return value is a
+    // status message suitable for the UI.
+    Q_INVOKABLE QString start(const QString &query);
+    Q_INVOKABLE void cancel();
+
+Q_SIGNALS:
+    void runningChanged();
+    void parallelismChanged();
+    void deviceTimeoutChanged();
+    void progressChanged();
+    void finished(const QString &report);
+
+private slots:
+    void jobFinished();
+
+private:
+    struct Target
+    {
+        QBluetoothDeviceInfo info;
+        QString adapter;
+        bool randomAddress;
+    };
+
+    void launchJobs();
+    QString writeReport();
+    void writeResult(JsonWriter &writer, const AuditResult &result);
+
+    Device *m_device;
+    QList<Target> m_queue;
+    QList<AuditJob*> m_jobs;
+    QList<AuditResult> m_results;
+    QElapsedTimer m_clock;
+    QDateTime m_started;
+    int m_parallelism;
+    int m_deviceTimeout;
+    int m_total;
+    int m_failed;
+    QString m_lastReport;
+};
+
+#endif // FLEETAUDIT_H
@@ -0,0 +1,450 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "gattsnapshot.h"
+#include "streamwriter.h"
+#include "device.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace {
+
+QString descriptorUuid(const QBluetoothUuid &uuid)
+{
+    return uuid.toString().remove(QLatin1Char('{')).remove(QLatin1Char('}'));
+}
+
+// Sorts both lists with less and walks them in step, matching entries
+// with equal UUIDs; entries sharing a UUID are paired in handle order.
+template <typename T, typename Less, typename Visit>
+void mergeByUuid(QList<T> before, QList<T> after, Less less, Visit visit)
+{
+    std::sort(before.begin(), before.end(), less);
+    std::sort(after.begin(), after.end(), less);
+
+    int i = 0;
+    int j = 0;
+    while (i < before.size() || j < after.size()) {
+        if (j == after.size() || (i < before.size() && before.at(i).uuid < after.at(j).uuid)) {
+            visit(&before.at(i), (const T *)0);
+            i++;
+        } else if (i == before.size() || after.at(j).uuid < before.at(i).uuid) {
+            visit((const T *)0, &after.at(j));
+            j++;
+        } else {
+            visit(&before.at(i), &after.at(j));
+            i++;
+            j++;
+        }
+    }
+}
+
+template <typename T>
+bool uuidHandleLess(const T &a, const T &b)
+{
+    if (a.uuid != b.uuid)
+        return a.uuid < b.uuid;
+    return a.handle < b.handle;
+}
+
+bool serviceLess(const GattServiceEntry &a, const GattServiceEntry &b)
+{
+    return a.uuid < b.uuid;
+}
+
+QString handleString(int handle)
+{
+    return QStringLiteral("0x") + QString::number(handle, 16);
+}
+
+GattDiffEntry diffEntry(GattDiffEntry::Kind kind, const QString &path, const QString &detail)
+{
+    GattDiffEntry entry;
+    entry.kind = kind;
+    entry.path = path;
+    entry.detail = detail;
+    return entry;
+}
+
+}
+
+GattSnapshot GattSnapshot::fromServices(const QList<QObject*> &services)
+{
+    GattSnapshot snapshot;
+    snapshot.taken = QDateTime::currentDateTime();
+    foreach (QObject *object, services) {
+        const ServiceInfo *s = (ServiceInfo*)object;
+        GattServiceEntry service;
+        service.uuid = s->getUuid();
+        service.name = s->getName();
+        service.type = s->service()->type();
+
+        foreach (const QLowEnergyCharacteristic &ch, s->service()->characteristics()) {
+            GattCharacteristicEntry characteristic;
+            characteristic.uuid = CharacteristicInfo::uuidOf(ch);
+            characteristic.name = CharacteristicInfo::nameOf(ch);
+            characteristic.handle = ch.handle();
+            characteristic.properties = ch.properties();
+            foreach (const QLowEnergyDescriptor &d, ch.descriptors()) {
+                GattDescriptorEntry descriptor;
+                descriptor.uuid = descriptorUuid(d.uuid());
+                descriptor.handle = d.handle();
+                characteristic.descriptors.append(descriptor);
+            }
+            service.characteristics.append(characteristic);
+        }
+        snapshot.services.append(service);
+    }
+    return snapshot;
+}
+
+bool GattSnapshot::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    JsonWriter writer(&file);
+    writer.beginObject();
+    writer.name("address");
+    writer.value(address);
+    writer.name("name");
+    writer.value(name);
+    writer.name("taken");
+    writer.value(taken.toString(Qt::ISODate));
+    writer.name("services");
+    writer.beginArray();
+    foreach (const GattServiceEntry &service, services) {
+        writer.beginObject();
+        writer.name("uuid");
+        writer.value(service.uuid);
+        writer.name("name");
+        writer.value(service.name);
+        writer.name("type");
+        writer.value(qint64(service.type));
+        writer.name("characteristics");
+        writer.beginArray();
+        foreach (const GattCharacteristicEntry &characteristic, service.characteristics) {
+            writer.beginObject();
+            writer.name("uuid");
+            writer.value(characteristic.uuid);
+            writer.name("name");
+            writer.value(characteristic.name);
+            writer.name("handle");
+            writer.value(qint64(characteristic.handle));
+            writer.name("properties");
+            writer.value(qint64(characteristic.properties));
+            writer.name("descriptors");
+            writer.beginArray();
+            foreach (const GattDescriptorEntry &descriptor, characteristic.descriptors) {
+                writer.beginObject();
+                writer.name("uuid");
+                writer.value(descriptor.uuid);
+                writer.name("handle");
+                writer.value(qint64(descriptor.handle));
+                writer.endObject();
+            }
+            writer.endArray();
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+
+    return !writer.hasError();
+}
+
+GattSnapshot GattSnapshot::load(const QString &fileName, QString *error)
+{
+    GattSnapshot snapshot;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return snapshot;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        *error = parseError.errorString();
+        return snapshot;
+    }
+
+    const QJsonObject root = document.object();
+    snapshot.address = root.value("address").toString();
+    snapshot.name = root.value("name").toString();
+    snapshot.taken = QDateTime::fromString(root.value("taken").toString(), Qt::ISODate);
+    foreach (const QJsonValue &serviceValue, root.value("services").toArray()) {
+        const QJsonObject serviceObject = serviceValue.toObject();
+        GattServiceEntry service;
+        service.uuid = serviceObject.value("uuid").toString();
+        service.name = serviceObject.value("name").toString();
+        service.type = serviceObject.value("type").toInt();
+        foreach (const QJsonValue &charValue, serviceObject.value("characteristics").toArray()) {
+            const QJsonObject charObject = charValue.toObject();
+            GattCharacteristicEntry characteristic;
+            characteristic.uuid = charObject.value("uuid").toString();
+            characteristic.name = charObject.value("name").toString();
+            characteristic.handle = charObject.value("handle").toInt();
+            characteristic.properties = charObject.value("properties").toInt();
+            foreach (const QJsonValue &descValue, charObject.value("descriptors").toArray()) {
+                const QJsonObject descObject = descValue.toObject();
+                GattDescriptorEntry descriptor;
+                descriptor.uuid = descObject.value("uuid").toString();
+                descriptor.handle = descObject.value("handle").toInt();
+                characteristic.descriptors.append(descriptor);
+            }
+            service.characteristics.append(characteristic);
+        }
+        snapshot.services.append(service);
+    }
+    return snapshot;
+}
+
+QList<GattDiffEntry> diffGattSnapshots(const GattSnapshot &before, const GattSnapshot &after)
+{
+    QList<GattDiffEntry> result;
+
+    mergeByUuid(before.services, after.services, serviceLess,
+                [&result](const GattServiceEntry *a, const GattServiceEntry *b) {
+        const QString servicePath = QStringLiteral("Service ") + (a ? a->uuid : b->uuid);
+        if (!a) {
+            result.append(diffEntry(GattDiffEntry::Added, servicePath, b->name));
+            return;
+        }
+        if (!b) {
+            result.append(diffEntry(GattDiffEntry::Removed, servicePath, a->name));
+            return;
+        }
+        if (a->type != b->type)
+            result.append(diffEntry(GattDiffEntry::Changed, servicePath, QStringLiteral("type changed")));
+
+        mergeByUuid(a->characteristics, b->characteristics, uuidHandleLess<GattCharacteristicEntry>,
+                    [&result, &servicePath](const GattCharacteristicEntry *x, const GattCharacteristicEntry *y) {
+            const QString charPath = servicePath + QStringLiteral(" / Characteristic ") + (x ? x->uuid : y->uuid);
+            if (!x) {
+                result.append(diffEntry(GattDiffEntry::Added, charPath,
+                                        QStringLiteral("handle ") + handleString(y->handle)));
+                return;
+            }
+            if (!y) {
+                result.append(diffEntry(GattDiffEntry::Removed, charPath,
+                                        QStringLiteral("handle ") + handleString(x->handle)));
+                return;
+            }
+            if (x->handle != y->handle) {
+                result.append(diffEntry(GattDiffEntry::Changed, charPath,
+                                        QString("handle %1 -> %2").arg(handleString(x->handle),
+                                                                       handleString(y->handle))));
+            }
+            if (x->properties != y->properties) {
+                const QString from = CharacteristicInfo::propertyNames(x->properties).join(QLatin1Char(' '));
+                const QString to = CharacteristicInfo::propertyNames(y->properties).join(QLatin1Char(' '));
+                result.append(diffEntry(GattDiffEntry::Changed, charPath,
+                                        QString("properties %1 -> %2").arg(from, to)));
+            }
+
+            mergeByUuid(x->descriptors, y->descriptors, uuidHandleLess<GattDescriptorEntry>,
+                        [&result, &charPath](const GattDescriptorEntry *d, const GattDescriptorEntry *e) {
+                const QString descPath = charPath + QStringLiteral(" / Descriptor ") + (d ? d->uuid : e->uuid);
+                if (!d)
+                    result.append(diffEntry(GattDiffEntry::Added, descPath, QStringLiteral("handle ") + handleString(e->handle)));
+                else if (!e)
+                    result.append(diffEntry(GattDiffEntry::Removed, descPath, QStringLiteral("handle ") + handleString(d->handle)));
+                else if (d->handle != e->handle)
+                    result.append(diffEntry(GattDiffEntry::Changed, descPath,
+                                            QString("handle %1 -> %2").arg(handleString(d->handle),
+                                                                           handleString(e->handle))));
+            });
+        });
+    });
+
+    return result;
+}
+
+GattSnapshots::GattSnapshots(Device *device, QObject *parent):
+    QObject(parent), m_device(device)
+{
+}
+
+QVariant GattSnapshots::diff() const
+{
+    return m_diff;
+}
+
+QString GattSnapshots::summary() const
+{
+    return m_summary;
+}
+
+QString GattSnapshots::saveLive()
+{
+    GattSnapshot snapshot;
+    QString error;
+    if (!liveSnapshot(&snapshot, &error))
+        return error;
+
+    QDir().mkpath(directory());
+    QString address = snapshot.address;
+    address.remove(QLatin1Char(':'));
+    const QString fileName = QString("%1/gatt-%2-%3.json").arg(directory(), address,
+                                                              snapshot.taken.toString("yyyyMMdd-hhmmss"));
+    if (!snapshot.save(fileName))
+        return QStringLiteral("Saving the snapshot failed");
+    return QString("Snapshot saved to %1").arg(fileName);
+}
+
+QString GattSnapshots::compare(const QString &before, const QString &after)
+{
+    QString error;
+    const GattSnapshot a = GattSnapshot::load(before, &error);
+    if (!error.isEmpty())
+        return QString("Cannot load %1: %2").arg(before, error);
+    const GattSnapshot b = GattSnapshot::load(after, &error);
+    if (!error.isEmpty())
+        return QString("Cannot load %1: %2").arg(after, error);
+    return setDiff(a, b);
+}
+
+QString GattSnapshots::compareLive(const QString &before)
+{
+    QString error;
+    const GattSnapshot a = GattSnapshot::load(before, &error);
+    if (!error.isEmpty())
+        return QString("Cannot load %1: %2").arg(before, error);
+
+    GattSnapshot b;
+    if (!liveSnapshot(&b, &error))
+        return error;
+    return setDiff(a, b);
+}
+
+QString GattSnapshots::compareLiveWithLatest()
+{
+    // prefer the newest snapshot of the same device, any device otherwise
+    QString address = m_device->connectedDevice()->getAddress();
+    address.remove(QLatin1Char(':'));
+    const QStringList saved = savedSnapshots();
+    QString latest = saved.isEmpty() ? QString() : saved.first();
+    foreach (const QString &fileName, saved) {
+        if (QFileInfo(fileName).fileName().startsWith(QStringLiteral("gatt-") + address)) {
+            latest = fileName;
+            break;
+        }
+    }
+
+    if (latest.isEmpty())
+        return QStringLiteral("No saved snapshot to compare with");
+    return compareLive(latest);
+}
+
+QStringList GattSnapshots::savedSnapshots() const
+{
+    QStringList result;
+    const QFileInfoList files = QDir(directory()).entryInfoList(QStringList() << "gatt-*.json",
+                                                                QDir::Files, QDir::Time);
+    foreach (const QFileInfo &info, files)
+        result.append(info.absoluteFilePath());
+    return result;
+}
+
+bool GattSnapshots::liveSnapshot(GattSnapshot *snapshot, QString *error)
+{
+    const QList<QObject*> &services = m_device->serviceObjects();
+    if (services.isEmpty()) {
+        *error = QStringLiteral("No services discovered");
+        return false;
+    }
+
+    // a snapshot is only meaningful once every service was explored
+    bool complete = true;
+    foreach (QObject *object, services) {
+        QLowEnergyService *service = ((ServiceInfo*)object)->service();
+        if (service->state() == QLowEnergyService::DiscoveryRequired)
+            service->discoverDetails();
+        if (service->state() != QLowEnergyService::ServiceDiscovered)
+            complete = false;
+    }
+    if (!complete) {
+        *error = QStringLiteral("Discovering all service details, try again");
+        return false;
+    }
+
+    *snapshot = GattSnapshot::fromServices(services);
+    snapshot->address = m_device->connectedDevice()->getAddress();
+    snapshot->name = m_device->connectedDevice()->getName();
+    return true;
+}
+
+QString GattSnapshots::setDiff(const GattSnapshot &before, const GattSnapshot &after)
+{
+    static const char *kinds[] = { "added", "removed", "changed" };
+
+    const QList<GattDiffEntry> entries = diffGattSnapshots(before, after);
+    m_diff.clear();
+    foreach (const GattDiffEntry &entry, entries) {
+        QVariantMap item;
+        item.insert("kind", QString::fromLatin1(kinds[entry.kind]));
+        item.insert("path", entry.path);
+        item.insert("detail", entry.detail);
+        m_diff.append(item);
+    }
+
+    if (entries.isEmpty())
+        m_summary = QStringLiteral("GATT layouts are identical");
+    else
+        m_summary = QString("%1 difference(s) between %2 and %3")
+                .arg(entries.size())
+                .arg(before.taken.toString(Qt::ISODate),
+                     after.taken.toString(Qt::ISODate));
+    emit diffChanged();
+    return m_summary;
+}
+
+QString GattSnapshots::directory() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)
+            + QStringLiteral("/ble_scanner-snapshots");
+}
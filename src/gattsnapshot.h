@@ -0,0 +1,131 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef GATTSNAPSHOT_H
+#define GATTSNAPSHOT_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+class Device;
+
+struct GattDescriptorEntry
+{
+    QString uuid;
+    int handle;
+};
+
+struct GattCharacteristicEntry
+{
+    QString uuid;
+    QString name;
+    int handle;
+    int properties;
+    QList<GattDescriptorEntry> descriptors;
+};
+
+struct GattServiceEntry
+{
+    QString uuid;
+    QString name;
+    int type;
+    QList<GattCharacteristicEntry> characteristics;
+};
+
+// The GATT layout of one device as discovered at a point in time. Values
+// are not part of it, only the structure which firmware should keep.
+struct GattSnapshot
+{
+    QString address;
+    QString name;
+    QDateTime taken;
+    QList<GattServiceEntry> services;
+
+    static GattSnapshot fromServices(const QList<QObject*> &services);
+    static GattSnapshot load(const QString &fileName, QString *error);
+    bool save(const QString &fileName) const;
+};
+
+struct GattDiffEntry
+{
+    enum Kind { Added, Removed, Changed };
+    Kind kind;
+    QString path;
+    QString detail;
+};
+
+// Compares two snapshots by merging their service, characteristic and
+// descriptor lists sorted on UUID and handle.
+QList<GattDiffEntry> diffGattSnapshots(const GattSnapshot &before, const GattSnapshot &after);
+
+// Saves snapshots of the connected device and compares them.
+class GattSnapshots: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariant diff READ diff NOTIFY diffChanged)
+    Q_PROPERTY(QString summary READ summary NOTIFY diffChanged)
+public:
+    explicit GattSnapshots(Device *device, QObject *parent = 0);
+
+    QVariant diff() const;
+    QString summary() const;
+
+    // the return values are status messages suitable for the UI
+    Q_INVOKABLE QString saveLive();
+    Q_INVOKABLE QString compare(const QString &before, const QString &after);
+    Q_INVOKABLE QString compareLive(const QString &before);
+    Q_INVOKABLE QString compareLiveWithLatest();
+    Q_INVOKABLE QStringList savedSnapshots() const;
+
+Q_SIGNALS:
+    void diffChanged();
+
+private:
+    bool liveSnapshot(GattSnapshot *snapshot, QString *error);
+    QString setDiff(const GattSnapshot &before, const GattSnapshot &after);
+    QString directory() const;
+
+    Device *m_device;
+    QVariantList m_diff;
+    QString m_summary;
+};
+
+#endif // GATTSNAPSHOT_H
@@ -0,0 +1,156 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "hexviewmodel.h"
+
+namespace {
+
+const char hexDigits[] = "0123456789abcdef";
+
+}
+
+HexViewModel::HexViewModel(QObject *parent):
+    QAbstractListModel(parent), m_bytesPerRow(16)
+{
+}
+
+int HexViewModel::bytesPerRow() const
+{
+    return m_bytesPerRow;
+}
+
+void HexViewModel::setBytesPerRow(int bytes)
+{
+    bytes = qBound(1, bytes, 64);
+    if (bytes == m_bytesPerRow)
+        return;
+
+    beginResetModel();
+    m_bytesPerRow = bytes;
+    endResetModel();
+    emit bytesPerRowChanged();
+}
+
+int HexViewModel::size() const
+{
+    return m_buffer.size();
+}
+
+void HexViewModel::setBuffer(const QByteArray &buffer)
+{
+    // QByteArray is implicitly shared, this only takes a reference
+    if (buffer.size() == m_buffer.size()) {
+        // a notification of the same length, keep the view where it is
+        m_buffer = buffer;
+        if (rowCount() > 0)
+            emit dataChanged(index(0), index(rowCount() - 1));
+        return;
+    }
+
+    beginResetModel();
+    m_buffer = buffer;
+    endResetModel();
+    emit bufferChanged();
+}
+
+int HexViewModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return (m_buffer.size() + m_bytesPerRow - 1) / m_bytesPerRow;
+}
+
+QVariant HexViewModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+
+    switch (role) {
+    case OffsetRole:
+        return offsetText(index.row());
+    case HexRole:
+        return hexText(index.row());
+    case AsciiRole:
+        return asciiText(index.row());
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> HexViewModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles.insert(OffsetRole, "offset");
+    roles.insert(HexRole, "hex");
+    roles.insert(AsciiRole, "ascii");
+    return roles;
+}
+
+QString HexViewModel::offsetText(int row) const
+{
+    return QString::number(row * m_bytesPerRow, 16).rightJustified(8, QLatin1Char('0'));
+}
+
+QString HexViewModel::hexText(int row) const
+{
+    const int first = row * m_bytesPerRow;
+    const int count = qMin(m_bytesPerRow, m_buffer.size() - first);
+    const uchar *bytes = reinterpret_cast<const uchar *>(m_buffer.constData()) + first;
+
+    // "xx xx xx", padded so the ASCII column of the last row lines up
+    QString result(m_bytesPerRow * 3 - 1, QLatin1Char(' '));
+    QChar *out = result.data();
+    for (int i = 0; i < count; ++i) {
+        out[i * 3] = QLatin1Char(hexDigits[bytes[i] >> 4]);
+        out[i * 3 + 1] = QLatin1Char(hexDigits[bytes[i] & 0x0f]);
+    }
+    return result;
+}
+
+QString HexViewModel::asciiText(int row) const
+{
+    const int first = row * m_bytesPerRow;
+    const int count = qMin(m_bytesPerRow, m_buffer.size() - first);
+    const uchar *bytes = reinterpret_cast<const uchar *>(m_buffer.constData()) + first;
+
+    QString result(count, QLatin1Char('.'));
+    QChar *out = result.data();
+    for (int i = 0; i < count; ++i) {
+        if (bytes[i] >= 0x20 && bytes[i] < 0x7f)
+            out[i] = QLatin1Char(char(bytes[i]));
+    }
+    return result;
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef HEXVIEWMODEL_H
+#define HEXVIEWMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+
+// One row per bytesPerRow bytes of a buffer, with offset, hex and ASCII
+// columns. The buffer is shared with its owner and rows are formatted in
+// data(), so only the rows a view actually shows are ever turned into
+// strings.
+class HexViewModel: public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int bytesPerRow READ bytesPerRow WRITE setBytesPerRow NOTIFY bytesPerRowChanged)
+    Q_PROPERTY(int size READ size NOTIFY bufferChanged)
+public:
+    enum Roles {
+        OffsetRole = Qt::UserRole + 1,
+        HexRole,
+        AsciiRole
+    };
+
+    explicit HexViewModel(QObject *parent = 0);
+
+    int bytesPerRow() const;
+    void setBytesPerRow(int bytes);
+    int size() const;
+    void setBuffer(const QByteArray &buffer);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role) const;
+    QHash<int, QByteArray> roleNames() const;
+
+Q_SIGNALS:
+    void bytesPerRowChanged();
+    void bufferChanged();
+
+private:
+    QString offsetText(int row) const;
+    QString hexText(int row) const;
+    QString asciiText(int row) const;
+
+    QByteArray m_buffer;
+    int m_bytesPerRow;
+};
+
+#endif // HEXVIEWMODEL_H
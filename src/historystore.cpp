@@ -0,0 +1,585 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "historystore.h"
+#include "device.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QMap>
+#include <QStandardPaths>
+#include <QTextStream>
+
+namespace {
+
+struct TierInfo
+{
+    const char *name;
+    qint64 bucket;    // resolution in milliseconds
+    qint64 chunkSpan; // time covered by one chunk file
+};
+
+const qint64 minute = 60 * 1000;
+const qint64 hour = 60 * minute;
+const qint64 day = 24 * hour;
+
+const TierInfo tiers[] = {
+    { "raw", 1, hour },
+    { "minute", minute, day },
+    { "hour", hour, 7 * day }
+};
+
+struct HistoryRecord
+{
+    qint64 time;
+    quint32 id;
+    HistoryPoint point;
+};
+
+void putVarint(QByteArray *out, quint64 value)
+{
+    while (value >= 0x80) {
+        out->append(char(value | 0x80));
+        value >>= 7;
+    }
+    out->append(char(value));
+}
+
+void putSigned(QByteArray *out, qint64 value)
+{
+    // zigzag, small negative deltas stay small
+    putVarint(out, (quint64(value) << 1) ^ quint64(value >> 63));
+}
+
+bool getVarint(const char **p, const char *end, quint64 *value)
+{
+    *value = 0;
+    for (int shift = 0; *p < end && shift < 64; shift += 7) {
+        const uchar byte = uchar(*(*p)++);
+        *value |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool getSigned(const char **p, const char *end, qint64 *value)
+{
+    quint64 raw;
+    if (!getVarint(p, end, &raw))
+        return false;
+    *value = qint64(raw >> 1) ^ -qint64(raw & 1);
+    return true;
+}
+
+QString chunkFile(const QString &directory, int tier, qint64 start)
+{
+    return QString("%1/%2-%3.bin").arg(directory).arg(tiers[tier].name).arg(start);
+}
+
+// Calls visit(record) for every record in the chunks of tier which
+// overlap [from, to). Only those chunk files are opened.
+template <typename Visit>
+void scanChunks(const QString &directory, int tier, qint64 from, qint64 to, Visit visit)
+{
+    const TierInfo &info = tiers[tier];
+    const qint64 first = from - from % info.chunkSpan;
+
+    for (qint64 start = first; start < to; start += info.chunkSpan) {
+        QFile file(chunkFile(directory, tier, start));
+        if (!file.exists() || !file.open(QIODevice::ReadOnly))
+            continue;
+
+        const QByteArray data = file.readAll();
+        const char *p = data.constData();
+        const char *end = p + data.size();
+
+        // a chunk is a sequence of blocks: byte length, absolute bucket of
+        // the first record and then records with bucket deltas
+        while (p < end) {
+            quint64 length;
+            if (!getVarint(&p, end, &length) || length > quint64(end - p))
+                break;
+            const char *blockEnd = p + length;
+
+            quint64 base;
+            if (!getVarint(&p, blockEnd, &base)) {
+                p = blockEnd;
+                continue;
+            }
+
+            qint64 bucket = qint64(base);
+            while (p < blockEnd) {
+                qint64 delta;
+                quint64 id;
+                if (!getSigned(&p, blockEnd, &delta) || !getVarint(&p, blockEnd, &id))
+                    break;
+                bucket += delta;
+
+                HistoryRecord record;
+                record.time = bucket * info.bucket;
+                record.id = quint32(id);
+                if (tier == HistoryStore::Raw) {
+                    if (p >= blockEnd)
+                        break;
+                    const int rssi = qint8(*p++);
+                    record.point.minimum = record.point.maximum = record.point.mean = rssi;
+                    record.point.count = 1;
+                } else {
+                    quint64 count;
+                    if (blockEnd - p < 3)
+                        break;
+                    record.point.minimum = qint8(*p++);
+                    record.point.maximum = qint8(*p++);
+                    record.point.mean = qint8(*p++);
+                    if (!getVarint(&p, blockEnd, &count))
+                        break;
+                    record.point.count = int(count);
+                }
+                record.point.time = record.time;
+
+                if (record.time >= from && record.time < to)
+                    visit(record);
+            }
+            p = blockEnd;
+        }
+    }
+}
+
+// rollups of one bucket can be split over several records when the app
+// was restarted inside the bucket
+void mergePoint(HistoryPoint *into, const HistoryPoint &point)
+{
+    const int count = into->count + point.count;
+    into->mean = int((qint64(into->mean) * into->count + qint64(point.mean) * point.count) / count);
+    into->minimum = qMin(into->minimum, point.minimum);
+    into->maximum = qMax(into->maximum, point.maximum);
+    into->count = count;
+}
+
+QVariantList pointList(const QList<HistoryPoint> &points)
+{
+    QVariantList result;
+    foreach (const HistoryPoint &point, points) {
+        QVariantMap map;
+        map.insert("time", QDateTime::fromMSecsSinceEpoch(point.time));
+        map.insert("minimum", point.minimum);
+        map.insert("maximum", point.maximum);
+        map.insert("mean", point.mean);
+        map.insert("count", point.count);
+        result.append(map);
+    }
+    return result;
+}
+
+}
+
+HistoryStore::HistoryStore(Device *device, const QString &directory, QObject *parent):
+    QObject(parent), m_device(device), m_directory(directory), m_enabled(true),
+    m_rawRetentionDays(14), m_minuteBucket(-1), m_hourBucket(-1)
+{
+    if (m_directory.isEmpty()) {
+        m_directory = QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+                + QStringLiteral("/history");
+    }
+    QDir().mkpath(m_directory);
+
+    for (int tier = 0; tier < 3; ++tier) {
+        m_chunks[tier].start = -1;
+        m_chunks[tier].lastBucket = 0;
+    }
+
+    // device ids are the line numbers of the address list
+    QFile ids(m_directory + QStringLiteral("/devices.txt"));
+    if (ids.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&ids);
+        while (!in.atEnd()) {
+            const QString address = in.readLine();
+            m_ids.insert(address, quint32(m_addresses.size()));
+            m_addresses.append(address);
+        }
+    }
+
+    m_flushTimer.setInterval(30000);
+    connect(&m_flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+    m_flushTimer.start();
+
+    if (m_device)
+        connect(m_device, SIGNAL(deviceSeen(QString)), this, SLOT(deviceSeen(QString)));
+}
+
+HistoryStore::~HistoryStore()
+{
+    // partial rollups are written too, queries merge them with the rest
+    // of their bucket after a restart
+    closeRollup(Minute, m_minuteBucket, &m_minute);
+    closeRollup(Hour, m_hourBucket, &m_hour);
+    flush();
+}
+
+bool HistoryStore::enabled() const
+{
+    return m_enabled;
+}
+
+void HistoryStore::setEnabled(bool enabled)
+{
+    if (enabled == m_enabled)
+        return;
+
+    m_enabled = enabled;
+    if (!m_enabled)
+        flush();
+    emit enabledChanged();
+}
+
+int HistoryStore::rawRetentionDays() const
+{
+    return m_rawRetentionDays;
+}
+
+void HistoryStore::setRawRetentionDays(int days)
+{
+    if (days == m_rawRetentionDays)
+        return;
+
+    m_rawRetentionDays = days;
+    emit rawRetentionDaysChanged();
+    // don't wait for the next raw chunk to apply a shorter retention
+    removeExpiredRaw(QDateTime::currentMSecsSinceEpoch());
+}
+
+qint64 HistoryStore::diskUsage() const
+{
+    qint64 result = 0;
+    foreach (const QFileInfo &info, QDir(m_directory).entryInfoList(QDir::Files))
+        result += info.size();
+    return result;
+}
+
+void HistoryStore::deviceSeen(const QString &address)
+{
+    const DeviceInfo *info = m_device->deviceInfo(address);
+    if (info)
+        record(address, info->getRssi(), QDateTime::currentMSecsSinceEpoch());
+}
+
+void HistoryStore::record(const QString &address, int rssi, qint64 time)
+{
+    if (!m_enabled)
+        return;
+
+    const quint32 id = deviceId(address);
+    rssi = qBound(-128, rssi, 127);
+
+    // raw samples are thinned out to one per device and second, the
+    // rollups still see every sighting
+    QHash<quint32, qint64>::iterator last = m_lastRaw.find(id);
+    if (last == m_lastRaw.end() || time - *last >= 1000 || time < *last) {
+        m_lastRaw.insert(id, time);
+        QByteArray record;
+        putVarint(&record, id);
+        record.append(char(rssi));
+        append(Raw, time, record);
+    }
+
+    const qint64 minuteBucket = time / minute;
+    if (minuteBucket != m_minuteBucket) {
+        closeRollup(Minute, m_minuteBucket, &m_minute);
+        m_minuteBucket = minuteBucket;
+    }
+    const qint64 hourBucket = time / hour;
+    if (hourBucket != m_hourBucket) {
+        closeRollup(Hour, m_hourBucket, &m_hour);
+        m_hourBucket = hourBucket;
+    }
+
+    QHash<quint32, Aggregate> *rollups[] = { &m_minute, &m_hour };
+    for (int i = 0; i < 2; ++i) {
+        QHash<quint32, Aggregate>::iterator it = rollups[i]->find(id);
+        if (it == rollups[i]->end()) {
+            Aggregate aggregate = { rssi, rssi, rssi, 1 };
+            rollups[i]->insert(id, aggregate);
+        } else {
+            it->minimum = qMin(it->minimum, rssi);
+            it->maximum = qMax(it->maximum, rssi);
+            it->sum += rssi;
+            ++it->count;
+        }
+    }
+}
+
+QList<HistoryPoint> HistoryStore::points(const QString &address, qint64 from, qint64 to,
+                                         Resolution resolution)
+{
+    return series(QStringList() << address, from, to, resolution).value(address);
+}
+
+QHash<QString, QList<HistoryPoint> > HistoryStore::series(const QStringList &addresses,
+                                                          qint64 from, qint64 to,
+                                                          Resolution resolution)
+{
+    QHash<QString, QList<HistoryPoint> > result;
+    QHash<quint32, QList<HistoryPoint> > raw;
+    QHash<quint32, QMap<qint64, HistoryPoint> > merged;
+    foreach (const QString &address, addresses) {
+        QHash<QString, quint32>::const_iterator it = m_ids.constFind(address);
+        if (it == m_ids.constEnd())
+            continue;
+        if (resolution == Raw)
+            raw.insert(*it, QList<HistoryPoint>());
+        else
+            merged.insert(*it, QMap<qint64, HistoryPoint>());
+    }
+    if (raw.isEmpty() && merged.isEmpty())
+        return result;
+
+    flush();
+    scanChunks(m_directory, resolution, from, to, [&](const HistoryRecord &record) {
+        if (resolution == Raw) {
+            QHash<quint32, QList<HistoryPoint> >::iterator series = raw.find(record.id);
+            if (series != raw.end())
+                series->append(record.point);
+            return;
+        }
+        QHash<quint32, QMap<qint64, HistoryPoint> >::iterator series = merged.find(record.id);
+        if (series == merged.end())
+            return;
+        QMap<qint64, HistoryPoint>::iterator it = series->find(record.time);
+        if (it == series->end())
+            series->insert(record.time, record.point);
+        else
+            mergePoint(&it.value(), record.point);
+    });
+
+    // the rollup in progress is only in memory, its bucket may also have a
+    // partial record on disk from before a restart
+    const QHash<quint32, Aggregate> &open = resolution == Minute ? m_minute : m_hour;
+    const qint64 openBucket = resolution == Minute ? m_minuteBucket : m_hourBucket;
+    const qint64 openTime = openBucket * tiers[resolution].bucket;
+    if (!merged.isEmpty() && openBucket >= 0 && openTime >= from && openTime < to) {
+        QHash<quint32, QMap<qint64, HistoryPoint> >::iterator series = merged.begin();
+        for (; series != merged.end(); ++series) {
+            QHash<quint32, Aggregate>::const_iterator aggregate = open.constFind(series.key());
+            if (aggregate == open.constEnd())
+                continue;
+            HistoryPoint point;
+            point.time = openTime;
+            point.minimum = aggregate->minimum;
+            point.maximum = aggregate->maximum;
+            point.mean = int(aggregate->sum / aggregate->count);
+            point.count = aggregate->count;
+            QMap<qint64, HistoryPoint>::iterator it = series->find(openTime);
+            if (it == series->end())
+                series->insert(openTime, point);
+            else
+                mergePoint(&it.value(), point);
+        }
+    }
+
+    QHash<quint32, QList<HistoryPoint> >::const_iterator it = raw.constBegin();
+    for (; it != raw.constEnd(); ++it)
+        result.insert(m_addresses.at(it.key()), it.value());
+    QHash<quint32, QMap<qint64, HistoryPoint> >::const_iterator jt = merged.constBegin();
+    for (; jt != merged.constEnd(); ++jt)
+        result.insert(m_addresses.at(jt.key()), jt->values());
+    return result;
+}
+
+QStringList HistoryStore::devicesSeen(qint64 from, qint64 to)
+{
+    flush();
+    QSet<quint32> ids;
+    const auto collect = [&ids](const HistoryRecord &record) { ids.insert(record.id); };
+
+    // whole closed hours come from the hour rollups, the edges and the
+    // hour in progress from the minute rollups
+    qint64 hourFrom = (from + hour - 1) / hour * hour;
+    qint64 hourTo = to / hour * hour;
+    if (m_hourBucket >= 0)
+        hourTo = qMin(hourTo, m_hourBucket * hour);
+
+    if (hourFrom < hourTo) {
+        scanChunks(m_directory, Hour, hourFrom, hourTo, collect);
+        scanChunks(m_directory, Minute, from, hourFrom, collect);
+        scanChunks(m_directory, Minute, hourTo, to, collect);
+    } else {
+        scanChunks(m_directory, Minute, from, to, collect);
+    }
+
+    // and the minute in progress from memory
+    const qint64 openMinute = m_minuteBucket * minute;
+    if (m_minuteBucket >= 0 && openMinute >= from && openMinute < to) {
+        foreach (quint32 id, m_minute.keys())
+            ids.insert(id);
+    }
+
+    QStringList result;
+    foreach (quint32 id, ids) {
+        if (id < quint32(m_addresses.size()))
+            result.append(m_addresses.at(id));
+    }
+    result.sort();
+    return result;
+}
+
+QVariantList HistoryStore::rssiHistory(const QString &address, const QDateTime &from,
+                                       const QDateTime &to, int resolution)
+{
+    return pointList(points(address, from.toMSecsSinceEpoch(), to.toMSecsSinceEpoch(),
+                            Resolution(resolution)));
+}
+
+QVariantMap HistoryStore::rssiHistories(const QStringList &addresses, const QDateTime &from,
+                                        const QDateTime &to, int resolution)
+{
+    QVariantMap result;
+    const QHash<QString, QList<HistoryPoint> > all = series(addresses, from.toMSecsSinceEpoch(),
+                                                            to.toMSecsSinceEpoch(),
+                                                            Resolution(resolution));
+    QHash<QString, QList<HistoryPoint> >::const_iterator it = all.constBegin();
+    for (; it != all.constEnd(); ++it)
+        result.insert(it.key(), pointList(it.value()));
+    return result;
+}
+
+QStringList HistoryStore::devicesSeenBetween(const QDateTime &from, const QDateTime &to)
+{
+    return devicesSeen(from.toMSecsSinceEpoch(), to.toMSecsSinceEpoch());
+}
+
+void HistoryStore::flush()
+{
+    bool written = false;
+    for (int tier = 0; tier < 3; ++tier) {
+        if (!m_chunks[tier].pending.isEmpty()) {
+            writeChunk(tier, &m_chunks[tier]);
+            written = true;
+        }
+    }
+    if (written)
+        emit flushed();
+}
+
+quint32 HistoryStore::deviceId(const QString &address)
+{
+    QHash<QString, quint32>::const_iterator it = m_ids.constFind(address);
+    if (it != m_ids.constEnd())
+        return *it;
+
+    const quint32 id = quint32(m_addresses.size());
+    m_ids.insert(address, id);
+    m_addresses.append(address);
+
+    QFile ids(m_directory + QStringLiteral("/devices.txt"));
+    if (ids.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        ids.write(address.toLatin1() + '\n');
+    else
+        qWarning() << "Cannot write" << ids.fileName() << ids.errorString();
+    return id;
+}
+
+void HistoryStore::append(int tier, qint64 time, const QByteArray &record)
+{
+    const TierInfo &info = tiers[tier];
+    const qint64 bucket = time / info.bucket;
+    const qint64 start = time - time % info.chunkSpan;
+
+    OpenChunk &chunk = m_chunks[tier];
+    if (chunk.start != start) {
+        if (!chunk.pending.isEmpty())
+            writeChunk(tier, &chunk);
+        chunk.start = start;
+        if (tier == Raw)
+            removeExpiredRaw(time);
+    }
+
+    if (chunk.pending.isEmpty()) {
+        putVarint(&chunk.pending, quint64(bucket));
+        chunk.lastBucket = bucket;
+    }
+    putSigned(&chunk.pending, bucket - chunk.lastBucket);
+    chunk.pending.append(record);
+    chunk.lastBucket = bucket;
+}
+
+void HistoryStore::closeRollup(int tier, qint64 bucket, QHash<quint32, Aggregate> *aggregates)
+{
+    if (bucket < 0 || aggregates->isEmpty())
+        return;
+
+    const qint64 time = bucket * tiers[tier].bucket;
+    QHash<quint32, Aggregate>::const_iterator it = aggregates->constBegin();
+    for (; it != aggregates->constEnd(); ++it) {
+        QByteArray record;
+        putVarint(&record, it.key());
+        record.append(char(it->minimum));
+        record.append(char(it->maximum));
+        record.append(char(qBound(-128, int(it->sum / it->count), 127)));
+        putVarint(&record, quint64(it->count));
+        append(tier, time, record);
+    }
+    aggregates->clear();
+}
+
+void HistoryStore::writeChunk(int tier, OpenChunk *chunk)
+{
+    QFile file(chunkFile(m_directory, tier, chunk->start));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Cannot write" << file.fileName() << file.errorString();
+        return;
+    }
+
+    QByteArray block;
+    putVarint(&block, quint64(chunk->pending.size()));
+    block.append(chunk->pending);
+    file.write(block);
+    chunk->pending.clear();
+}
+
+void HistoryStore::removeExpiredRaw(qint64 now)
+{
+    const qint64 limit = now - m_rawRetentionDays * day;
+    const QString prefix = QString::fromLatin1(tiers[Raw].name) + QLatin1Char('-');
+    foreach (const QString &name, QDir(m_directory).entryList(QStringList() << prefix + "*.bin",
+                                                              QDir::Files)) {
+        const qint64 start = name.mid(prefix.size()).section(QLatin1Char('.'), 0, 0).toLongLong();
+        if (start + tiers[Raw].chunkSpan < limit)
+            QFile::remove(m_directory + QLatin1Char('/') + name);
+    }
+}
@@ -0,0 +1,159 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QTimer>
+#include <QVariant>
+
+class Device;
+
+struct HistoryPoint
+{
+    qint64 time;
+    int minimum;
+    int maximum;
+    int mean;
+    int count;
+};
+
+// Long term RSSI and presence history on disk. Every sighting is kept at
+// three resolutions: raw (at most one sample per device and second), one
+// minute and one hour rollups holding min, max, mean and count. Each
+// resolution is split into chunk files covering a fixed time span, the
+// records inside are delta encoded varints. A range query only opens the
+// chunks of the resolution it needs which overlap the range.
+class HistoryStore: public QObject
+{
+    Q_OBJECT
+    Q_ENUMS(Resolution)
+    Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(int rawRetentionDays READ rawRetentionDays WRITE setRawRetentionDays NOTIFY rawRetentionDaysChanged)
+    Q_PROPERTY(qint64 diskUsage READ diskUsage NOTIFY flushed)
+public:
+    enum Resolution { Raw, Minute, Hour };
+
+    explicit HistoryStore(Device *device, const QString &directory = QString(),
+                          QObject *parent = 0);
+    ~HistoryStore();
+
+    bool enabled() const;
+    void setEnabled(bool enabled);
+    // raw chunks older than this are deleted, rollups are kept
+    int rawRetentionDays() const;
+    void setRawRetentionDays(int days);
+    qint64 diskUsage() const;
+
+    void record(const QString &address, int rssi, qint64 time);
+
+    // times are milliseconds since the epoch, to is exclusive. The rollups
+    // still in progress are included.
+    QList<HistoryPoint> points(const QString &address, qint64 from, qint64 to,
+                               Resolution resolution);
+    // the points of several devices in a single pass over the chunks
+    QHash<QString, QList<HistoryPoint> > series(const QStringList &addresses, qint64 from,
+                                                qint64 to, Resolution resolution);
+    QStringList devicesSeen(qint64 from, qint64 to);
+
+    // QML wrappers, the points are maps with the HistoryPoint field names
+    Q_INVOKABLE QVariantList rssiHistory(const QString &address, const QDateTime &from,
+                                         const QDateTime &to, int resolution);
+    // maps each address to its rssiHistory() list
+    Q_INVOKABLE QVariantMap rssiHistories(const QStringList &addresses, const QDateTime &from,
+                                          const QDateTime &to, int resolution);
+    Q_INVOKABLE QStringList devicesSeenBetween(const QDateTime &from, const QDateTime &to);
+
+public slots:
+    void flush();
+
+Q_SIGNALS:
+    void enabledChanged();
+    void rawRetentionDaysChanged();
+    void flushed();
+
+private slots:
+    void deviceSeen(const QString &address);
+
+private:
+    struct Aggregate
+    {
+        int minimum;
+        int maximum;
+        qint64 sum;
+        int count;
+    };
+
+    struct OpenChunk
+    {
+        qint64 start;
+        // records not yet written, pending starts with the absolute bucket
+        // of its first record
+        QByteArray pending;
+        qint64 lastBucket;
+    };
+
+    quint32 deviceId(const QString &address);
+    void append(int tier, qint64 time, const QByteArray &record);
+    void closeRollup(int tier, qint64 bucket, QHash<quint32, Aggregate> *aggregates);
+    void writeChunk(int tier, OpenChunk *chunk);
+    void removeExpiredRaw(qint64 now);
+
+    Device *m_device;
+    QString m_directory;
+    QTimer m_flushTimer;
+    bool m_enabled;
+    int m_rawRetentionDays;
+
+    QHash<QString, quint32> m_ids;
+    QStringList m_addresses;
+    QHash<quint32, qint64> m_lastRaw;
+    OpenChunk m_chunks[3];
+    // rollups of the minute and hour still in progress
+    qint64 m_minuteBucket;
+    qint64 m_hourBucket;
+    QHash<quint32, Aggregate> m_minute;
+    QHash<quint32, Aggregate> m_hour;
+};
+
+#endif // HISTORYSTORE_H
@@ -0,0 +1,87 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef INSTANCECOUNTER_H
+#define INSTANCECOUNTER_H
+
+#include <QAtomicInt>
+
+// Live, peak and total instance numbers of one class. Updated from the
+// constructors and destructor of InstanceCounted, so it is safe to touch
+// from any thread.
+struct InstanceCount
+{
+    QAtomicInt live;
+    QAtomicInt peak;
+    QAtomicInt created;
+
+    void add()
+    {
+        created.ref();
+        const int now = live.fetchAndAddOrdered(1) + 1;
+        int seen = peak.load();
+        while (now > seen && !peak.testAndSetOrdered(seen, now))
+            seen = peak.load();
+    }
+
+    void remove()
+    {
+        live.deref();
+    }
+};
+
+// Base class that counts the instances of T, listed after QObject:
+//   class DeviceInfo: public QObject, public InstanceCounted<DeviceInfo>
+template <typename T>
+class InstanceCounted
+{
+public:
+    static const InstanceCount &instances() { return s_count; }
+
+protected:
+    InstanceCounted() { s_count.add(); }
+    InstanceCounted(const InstanceCounted &) { s_count.add(); }
+    ~InstanceCounted() { s_count.remove(); }
+
+private:
+    static InstanceCount s_count;
+};
+
+template <typename T>
+InstanceCount InstanceCounted<T>::s_count;
+
+#endif // INSTANCECOUNTER_H
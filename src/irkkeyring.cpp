@@ -0,0 +1,217 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "irkkeyring.h"
+#include <QBluetoothAddress>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <string.h>
+
+namespace {
+
+// addresses resolved or rejected before this many new ones come in are
+// forgotten, private addresses rotate every 15 minutes or so
+const int maxCacheSize = 8192;
+
+void addressBytes(const QString &address, uint8_t out[6])
+{
+    const quint64 value = QBluetoothAddress(address).toUInt64();
+    for (int i = 0; i < 6; ++i)
+        out[i] = uint8_t(value >> (8 * (5 - i)));
+}
+
+}
+
+IrkKeyring::IrkKeyring(QObject *parent):
+    QObject(parent)
+{
+    QString error;
+    if (QFile::exists(storedFile()) && !load(storedFile(), &error))
+        qWarning() << "Cannot load IRK keyring:" << error;
+}
+
+int IrkKeyring::count() const
+{
+    return m_keys.size();
+}
+
+QString IrkKeyring::implementation() const
+{
+    return QString::fromLatin1(Aes128::implementation());
+}
+
+bool IrkKeyring::isResolvable(const QString &address)
+{
+    const quint64 value = QBluetoothAddress(address).toUInt64();
+    return value != 0 && (value >> 46) == 0x1;
+}
+
+void IrkKeyring::resolve(const QVector<QString> &addresses)
+{
+    if (m_keys.isEmpty())
+        return;
+
+    if (m_cache.size() > maxCacheSize)
+        m_cache.clear();
+
+    m_pending.resize(0);
+    foreach (const QString &address, addresses) {
+        if (m_cache.contains(address) || !isResolvable(address))
+            continue;
+        // mark as seen so duplicates within the batch are skipped
+        m_cache.insert(address, QString());
+        m_pending.append(address);
+    }
+    if (m_pending.isEmpty())
+        return;
+
+    // ah(k, r) = e(k, 0^104 || prand), the hash is its low 24 bits
+    int pending = m_pending.size();
+    m_plain.fill(0, pending * 16);
+    m_cipher.resize(pending * 16);
+    for (int i = 0; i < pending; ++i) {
+        uint8_t bytes[6];
+        addressBytes(m_pending.at(i), bytes);
+        memcpy(m_plain.data() + 16 * i + 13, bytes, 3);
+    }
+
+    foreach (const Key &key, m_keys) {
+        key.cipher.encryptBlocks(m_plain.constData(), m_cipher.data(), size_t(pending));
+
+        // resolved addresses are swapped to the end so the next key only
+        // encrypts the ones still open
+        for (int i = 0; i < pending; ) {
+            uint8_t bytes[6];
+            addressBytes(m_pending.at(i), bytes);
+            if (memcmp(m_cipher.constData() + 16 * i + 13, bytes + 3, 3) != 0) {
+                ++i;
+                continue;
+            }
+
+            m_cache.insert(m_pending.at(i), key.identity);
+            --pending;
+            if (i != pending) {
+                m_pending[i].swap(m_pending[pending]);
+                memcpy(m_plain.data() + 16 * i, m_plain.constData() + 16 * pending, 16);
+                memcpy(m_cipher.data() + 16 * i, m_cipher.constData() + 16 * pending, 16);
+            }
+        }
+        if (pending == 0)
+            break;
+    }
+}
+
+QString IrkKeyring::identity(const QString &address) const
+{
+    const QString result = m_cache.value(address);
+    return result.isEmpty() ? address : result;
+}
+
+QString IrkKeyring::identityName(const QString &identity) const
+{
+    return m_names.value(identity);
+}
+
+QString IrkKeyring::importFile(const QString &fileName)
+{
+    QString source = fileName;
+    if (source.isEmpty()) {
+        source = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)
+                + QStringLiteral("/ble_scanner-irks.txt");
+    }
+
+    QString error;
+    if (!load(source, &error))
+        return QString("Import failed: %1").arg(error);
+
+    // keep a private copy, the keyring is loaded from it on start up
+    QDir().mkpath(QFileInfo(storedFile()).absolutePath());
+    QFile::remove(storedFile());
+    if (!QFile::copy(source, storedFile()))
+        qWarning() << "Cannot store IRK keyring in" << storedFile();
+
+    return QString("Imported %1 keys").arg(m_keys.size());
+}
+
+bool IrkKeyring::load(const QString &fileName, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *error = file.errorString();
+        return false;
+    }
+
+    QList<Key> keys;
+    QHash<QString, QString> names;
+    QTextStream in(&file);
+    for (int line = 1; !in.atEnd(); ++line) {
+        const QString text = in.readLine().trimmed();
+        if (text.isEmpty() || text.startsWith(QLatin1Char('#')))
+            continue;
+
+        const QStringList fields = text.split(QRegExp("\\s+"));
+        const QByteArray irk = QByteArray::fromHex(fields.value(1).toLatin1());
+        if (fields.size() < 2 || QBluetoothAddress(fields.at(0)).isNull() || irk.size() != 16) {
+            *error = QString("%1:%2: expected an address and a 128 bit key").arg(fileName).arg(line);
+            return false;
+        }
+
+        Key key;
+        key.identity = QBluetoothAddress(fields.at(0)).toString();
+        key.name = QStringList(fields.mid(2)).join(QLatin1Char(' '));
+        key.cipher.setKey(reinterpret_cast<const uint8_t *>(irk.constData()));
+        keys.append(key);
+        names.insert(key.identity, key.name);
+    }
+
+    m_keys = keys;
+    m_names = names;
+    m_cache.clear();
+    emit keysChanged();
+    return true;
+}
+
+QString IrkKeyring::storedFile() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+            + QStringLiteral("/irks.txt");
+}
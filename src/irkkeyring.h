@@ -0,0 +1,106 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef IRKKEYRING_H
+#define IRKKEYRING_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+#include "aes128.h"
+
+// Identity resolving keys of known devices. Resolvable private addresses
+// are checked against every key with the Bluetooth ah() function, the
+// outcome is cached per address since a device keeps one private address
+// for several minutes.
+//
+// Keys are imported from a text file with one device per line:
+//   <identity address> <IRK as 32 hex digits, most significant first> [name]
+// Empty lines and lines starting with '#' are ignored.
+class IrkKeyring: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY keysChanged)
+    Q_PROPERTY(QString implementation READ implementation CONSTANT)
+public:
+    explicit IrkKeyring(QObject *parent = 0);
+
+    int count() const;
+    // the AES implementation in use
+    QString implementation() const;
+
+    // random addresses with the two most significant bits 01
+    static bool isResolvable(const QString &address);
+
+    // resolves every address of the batch which is not cached yet, each
+    // key encrypts all pending addresses in one go
+    void resolve(const QVector<QString> &addresses);
+    // the identity address if address resolved, address itself otherwise
+    QString identity(const QString &address) const;
+    QString identityName(const QString &identity) const;
+
+    // an empty fileName imports ble_scanner-irks.txt from the documents
+    // folder, the return value is a status message suitable for the UI
+    Q_INVOKABLE QString importFile(const QString &fileName = QString());
+
+Q_SIGNALS:
+    void keysChanged();
+
+private:
+    struct Key
+    {
+        QString identity;
+        QString name;
+        Aes128 cipher;
+    };
+
+    bool load(const QString &fileName, QString *error);
+    QString storedFile() const;
+
+    QList<Key> m_keys;
+    QHash<QString, QString> m_names;
+    // resolved identity per address, an empty string if no key matched
+    QHash<QString, QString> m_cache;
+    // scratch space for resolve(), kept between batches
+    QVector<QString> m_pending;
+    QVector<uint8_t> m_plain;
+    QVector<uint8_t> m_cipher;
+};
+
+#endif // IRKKEYRING_H
@@ -0,0 +1,345 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "latencyprobe.h"
+#include "peripheralemulator.h"
+#include "device.h"
+#include <QDebug>
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// a round trip which takes longer than this counts as lost
+const int probeTimeout = 2000;
+
+}
+
+LatencyProbe::LatencyProbe(Device *device, int capacity, QObject *parent):
+    QObject(parent), m_device(device), m_mode(ReadRoundTrip), m_interval(100),
+    m_running(false), m_waiting(false), m_subscribed(false), m_sequence(0), m_pending(0),
+    m_capacity(capacity), m_count(0), m_lost(0), m_dirty(false), m_last(0),
+    m_minimum(0), m_median(0), m_p99(0), m_jitter(0)
+{
+    m_nextProbe.setSingleShot(true);
+    connect(&m_nextProbe, SIGNAL(timeout()), this, SLOT(sendProbe()));
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(probeTimeout);
+    connect(&m_timeout, SIGNAL(timeout()), this, SLOT(timedOut()));
+    m_statisticsTimer.setInterval(250);
+    connect(&m_statisticsTimer, SIGNAL(timeout()), this, SLOT(updateStatistics()));
+}
+
+QString LatencyProbe::characteristic() const
+{
+    return m_characteristic;
+}
+
+void LatencyProbe::setCharacteristic(const QString &uuid)
+{
+    if (uuid == m_characteristic)
+        return;
+
+    stop();
+    m_characteristic = uuid;
+    emit settingsChanged();
+}
+
+LatencyProbe::Mode LatencyProbe::mode() const
+{
+    return m_mode;
+}
+
+void LatencyProbe::setMode(Mode mode)
+{
+    if (mode == m_mode)
+        return;
+
+    stop();
+    m_mode = mode;
+    emit settingsChanged();
+}
+
+int LatencyProbe::interval() const
+{
+    return m_interval;
+}
+
+void LatencyProbe::setInterval(int interval)
+{
+    interval = qMax(0, interval);
+    if (interval == m_interval)
+        return;
+
+    m_interval = interval;
+    emit settingsChanged();
+}
+
+bool LatencyProbe::running() const
+{
+    return m_running;
+}
+
+int LatencyProbe::count() const
+{
+    return m_count;
+}
+
+int LatencyProbe::lost() const
+{
+    return m_lost;
+}
+
+double LatencyProbe::last() const
+{
+    return m_last;
+}
+
+double LatencyProbe::minimum() const
+{
+    return m_minimum;
+}
+
+double LatencyProbe::median() const
+{
+    return m_median;
+}
+
+double LatencyProbe::p99() const
+{
+    return m_p99;
+}
+
+double LatencyProbe::jitter() const
+{
+    return m_jitter;
+}
+
+QString LatencyProbe::start()
+{
+    stop();
+
+    m_service = m_device->currentService();
+    if (!m_service)
+        return QStringLiteral("No service open");
+
+    m_target = m_device->findCharacteristic(m_characteristic);
+    if (!m_target.isValid())
+        return QStringLiteral("Characteristic not found");
+
+    const QLowEnergyCharacteristic::PropertyTypes properties = m_target.properties();
+    if (m_mode == ReadRoundTrip) {
+        if (!(properties & QLowEnergyCharacteristic::Read))
+            return QStringLiteral("Characteristic is not readable");
+        connect(m_service, SIGNAL(characteristicRead(QLowEnergyCharacteristic,QByteArray)),
+                this, SLOT(characteristicRead(QLowEnergyCharacteristic,QByteArray)));
+    } else {
+        if (!(properties & (QLowEnergyCharacteristic::Write | QLowEnergyCharacteristic::WriteNoResponse)))
+            return QStringLiteral("Characteristic is not writable");
+
+        // The answer has to echo the written sequence number. It comes from
+        // the characteristic itself or from the echo characteristic of the
+        // peripheral emulator; any other notifying characteristic sends
+        // unrelated data and can't be used.
+        const int notifying = QLowEnergyCharacteristic::Notify | QLowEnergyCharacteristic::Indicate;
+        m_reply = QLowEnergyCharacteristic();
+        if (properties & notifying)
+            m_reply = m_target;
+        if (!m_reply.isValid())
+            m_reply = m_service->characteristic(QBluetoothUuid(QString::fromLatin1(PeripheralEmulator::echoCharacteristicUuid)));
+        if (!m_reply.isValid())
+            return QStringLiteral("No echo characteristic to answer the writes");
+
+        connect(m_service, SIGNAL(characteristicChanged(QLowEnergyCharacteristic,QByteArray)),
+                this, SLOT(characteristicChanged(QLowEnergyCharacteristic,QByteArray)));
+        m_device->setNotifications(m_reply, true);
+        m_subscribed = true;
+    }
+
+    // one allocation per run, the probe loop itself doesn't allocate
+    m_samples.fill(0, m_capacity);
+    m_sorted.fill(0, m_capacity);
+    resetStatistics();
+
+    m_running = true;
+    m_statisticsTimer.start();
+    emit runningChanged();
+
+    m_nextProbe.start(0);
+    return QStringLiteral("Probing");
+}
+
+void LatencyProbe::stop()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    m_waiting = false;
+    m_nextProbe.stop();
+    m_timeout.stop();
+    m_statisticsTimer.stop();
+
+    if (m_service) {
+        if (m_subscribed && m_reply.isValid())
+            m_device->setNotifications(m_reply, false);
+        disconnect(m_service, 0, this, 0);
+    }
+    m_subscribed = false;
+
+    updateStatistics();
+    emit runningChanged();
+}
+
+void LatencyProbe::sendProbe()
+{
+    if (!m_running || m_waiting)
+        return;
+
+    if (!m_service || m_service->state() != QLowEnergyService::ServiceDiscovered) {
+        qWarning() << "Latency probe lost its service";
+        stop();
+        return;
+    }
+
+    m_waiting = true;
+    m_timeout.start();
+    m_clock.start();
+
+    if (m_mode == ReadRoundTrip) {
+        m_service->readCharacteristic(m_target);
+    } else {
+        uchar payload[4];
+        m_pending = m_sequence++;
+        qToLittleEndian<quint32>(m_pending, payload);
+        const QLowEnergyService::WriteMode writeMode =
+                (m_target.properties() & QLowEnergyCharacteristic::Write)
+                ? QLowEnergyService::WriteWithResponse : QLowEnergyService::WriteWithoutResponse;
+        m_service->writeCharacteristic(m_target, QByteArray(reinterpret_cast<const char *>(payload), 4),
+                                       writeMode);
+    }
+}
+
+void LatencyProbe::characteristicRead(const QLowEnergyCharacteristic &characteristic,
+                                      const QByteArray &value)
+{
+    Q_UNUSED(value);
+    if (m_waiting && characteristic.handle() == m_target.handle())
+        finishProbe();
+}
+
+void LatencyProbe::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
+                                         const QByteArray &value)
+{
+    if (!m_waiting || characteristic.handle() != m_reply.handle() || value.size() < 4)
+        return;
+
+    // a late echo of a timed out probe or other traffic on the
+    // characteristic must not end the probe in flight
+    const quint32 sequence = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(value.constData()));
+    if (sequence == m_pending)
+        finishProbe();
+}
+
+void LatencyProbe::timedOut()
+{
+    if (!m_waiting)
+        return;
+
+    m_waiting = false;
+    ++m_lost;
+    m_dirty = true;
+    m_nextProbe.start(m_interval);
+}
+
+void LatencyProbe::finishProbe()
+{
+    const double sample = m_clock.nsecsElapsed() / 1000000.0;
+    m_waiting = false;
+    m_timeout.stop();
+
+    // interarrival jitter as in RFC 3550: a running mean of the absolute
+    // difference between consecutive samples with gain 1/16
+    if (m_count > 0)
+        m_jitter += (qAbs(sample - m_last) - m_jitter) / 16;
+    if (m_count == 0 || sample < m_minimum)
+        m_minimum = sample;
+    m_last = sample;
+    m_samples[m_count % m_capacity] = float(sample);
+    ++m_count;
+    m_dirty = true;
+
+    m_nextProbe.start(m_interval);
+}
+
+void LatencyProbe::updateStatistics()
+{
+    if (!m_dirty)
+        return;
+    m_dirty = false;
+
+    // order statistics over the samples still in the ring
+    const int n = qMin(m_count, m_capacity);
+    if (n > 0) {
+        float *begin = m_sorted.data();
+        std::copy(m_samples.constBegin(), m_samples.constBegin() + n, begin);
+
+        float *median = begin + n / 2;
+        std::nth_element(begin, median, begin + n);
+        m_median = *median;
+
+        float *p99 = begin + qMax(0, int(std::ceil(n * 0.99)) - 1);
+        std::nth_element(median, p99, begin + n);
+        m_p99 = *p99;
+    }
+
+    emit statisticsChanged();
+}
+
+void LatencyProbe::resetStatistics()
+{
+    m_count = 0;
+    m_lost = 0;
+    m_last = 0;
+    m_minimum = 0;
+    m_median = 0;
+    m_p99 = 0;
+    m_jitter = 0;
+    m_dirty = true;
+    updateStatistics();
+}
@@ -0,0 +1,146 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+#include <QtBluetooth/QLowEnergyService>
+
+class Device;
+
+// Measures round trips against a characteristic of the current service,
+// either a plain read or a write answered by a notification echoing the
+// written sequence number. The last capacity samples are kept in a buffer
+// allocated once per run, the statistics are recomputed from it a few
+// times per second.
+class LatencyProbe: public QObject
+{
+    Q_OBJECT
+    Q_ENUMS(Mode)
+    Q_PROPERTY(QString characteristic READ characteristic WRITE setCharacteristic NOTIFY settingsChanged)
+    Q_PROPERTY(Mode mode READ mode WRITE setMode NOTIFY settingsChanged)
+    Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY settingsChanged)
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(int count READ count NOTIFY statisticsChanged)
+    Q_PROPERTY(int lost READ lost NOTIFY statisticsChanged)
+    Q_PROPERTY(double last READ last NOTIFY statisticsChanged)
+    Q_PROPERTY(double minimum READ minimum NOTIFY statisticsChanged)
+    Q_PROPERTY(double median READ median NOTIFY statisticsChanged)
+    Q_PROPERTY(double p99 READ p99 NOTIFY statisticsChanged)
+    Q_PROPERTY(double jitter READ jitter NOTIFY statisticsChanged)
+public:
+    enum Mode { ReadRoundTrip, WriteNotifyRoundTrip };
+
+    explicit LatencyProbe(Device *device, int capacity = 4096, QObject *parent = 0);
+
+    QString characteristic() const;
+    void setCharacteristic(const QString &uuid);
+    Mode mode() const;
+    void setMode(Mode mode);
+    // pause between round trips in milliseconds
+    int interval() const;
+    void setInterval(int interval);
+    bool running() const;
+
+    // all times are in milliseconds
+    int count() const;
+    int lost() const;
+    double last() const;
+    double minimum() const;
+    double median() const;
+    double p99() const;
+    double jitter() const;
+
+    // the return value is a status message suitable for the UI
+    Q_INVOKABLE QString start();
+    Q_INVOKABLE void stop();
+
+Q_SIGNALS:
+    void settingsChanged();
+    void runningChanged();
+    void statisticsChanged();
+
+private slots:
+    void sendProbe();
+    void characteristicRead(const QLowEnergyCharacteristic &characteristic, const QByteArray &value);
+    void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &value);
+    void timedOut();
+    void updateStatistics();
+
+private:
+    void finishProbe();
+    void resetStatistics();
+
+    Device *m_device;
+    QPointer<QLowEnergyService> m_service;
+    QLowEnergyCharacteristic m_target;
+    QLowEnergyCharacteristic m_reply;
+    QString m_characteristic;
+    Mode m_mode;
+    int m_interval;
+    bool m_running;
+    bool m_waiting;
+    bool m_subscribed;
+    quint32 m_sequence;
+    // sequence number written by the probe in flight
+    quint32 m_pending;
+    QElapsedTimer m_clock;
+    QTimer m_nextProbe;
+    QTimer m_timeout;
+    QTimer m_statisticsTimer;
+
+    // ring of the last samples and a scratch copy for the order
+    // statistics, both sized in start()
+    QVector<float> m_samples;
+    QVector<float> m_sorted;
+    int m_capacity;
+    int m_count;
+    int m_lost;
+    bool m_dirty;
+    double m_last;
+    double m_minimum;
+    double m_median;
+    double m_p99;
+    double m_jitter;
+};
+
+#endif // LATENCYPROBE_H
@@ -0,0 +1,215 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "memorystats.h"
+#include "instancecounter.h"
+#include "device.h"
+#include "fleetaudit.h"
+#include <QDebug>
+#include <QFile>
+
+MemoryStats::MemoryStats(Device *device, FleetAudit *audit, QObject *parent):
+    QObject(parent), m_device(device), m_audit(audit), m_peakServiceObjects(0),
+    m_characteristicBytes(0), m_peakCharacteristicBytes(0),
+    m_historyBytes(0), m_peakHistoryBytes(0),
+    m_residentKb(-1), m_peakResidentKb(-1), m_droppedRecords(0)
+{
+    m_timer.setInterval(1000);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(refresh()));
+}
+
+bool MemoryStats::active() const
+{
+    return m_timer.isActive();
+}
+
+void MemoryStats::setActive(bool active)
+{
+    if (active == m_timer.isActive())
+        return;
+
+    if (active) {
+        refresh();
+        m_timer.start();
+    } else {
+        m_timer.stop();
+    }
+    emit activeChanged();
+}
+
+QVariantList MemoryStats::counters() const
+{
+    return m_counters;
+}
+
+qint64 MemoryStats::characteristicBytes() const
+{
+    return m_characteristicBytes;
+}
+
+qint64 MemoryStats::peakCharacteristicBytes() const
+{
+    return m_peakCharacteristicBytes;
+}
+
+qint64 MemoryStats::historyBytes() const
+{
+    return m_historyBytes;
+}
+
+qint64 MemoryStats::peakHistoryBytes() const
+{
+    return m_peakHistoryBytes;
+}
+
+qint64 MemoryStats::residentKb() const
+{
+    return m_residentKb;
+}
+
+qint64 MemoryStats::peakResidentKb() const
+{
+    return m_peakResidentKb;
+}
+
+int MemoryStats::droppedRecords() const
+{
+    return m_droppedRecords;
+}
+
+QString MemoryStats::report()
+{
+    refresh();
+
+    QStringList parts;
+    foreach (const QVariant &counter, m_counters) {
+        const QVariantMap map = counter.toMap();
+        parts << QString("%1 %2/%3").arg(map.value("name").toString())
+                 .arg(map.value("live").toInt()).arg(map.value("peak").toInt());
+    }
+    const QString result = QString("%1; values %2 B (peak %3), history %4 B (peak %5), RSS %6 kB (peak %7), dropped %8")
+            .arg(parts.join(QStringLiteral(", ")))
+            .arg(m_characteristicBytes).arg(m_peakCharacteristicBytes)
+            .arg(m_historyBytes).arg(m_peakHistoryBytes)
+            .arg(m_residentKb).arg(m_peakResidentKb)
+            .arg(m_droppedRecords);
+    qInfo() << "Memory:" << result;
+    return result;
+}
+
+void MemoryStats::refresh()
+{
+    // characteristic and descriptor values are implicitly shared between
+    // QLowEnergyService and CharacteristicInfo, count them once per service
+    qint64 valueBytes = 0;
+    foreach (QObject *object, m_device->serviceObjects()) {
+        const ServiceInfo *s = (ServiceInfo*)object;
+        if (!s->service())
+            continue;
+        foreach (const QLowEnergyCharacteristic &ch, s->service()->characteristics()) {
+            valueBytes += ch.value().size();
+            foreach (const QLowEnergyDescriptor &descriptor, ch.descriptors())
+                valueBytes += descriptor.value().size();
+        }
+    }
+
+    const QHash<QString, PresenceEntry> &presence = m_device->presence()->entries();
+    const qint64 historyBytes = m_device->plotSeries()->memoryUsage()
+            + qint64(presence.capacity()) * (sizeof(PresenceEntry) + sizeof(QString));
+
+    // "listed" includes the objects which are owned elsewhere on purpose:
+    // Device::connectedDevice() and the services of running audit jobs
+    m_counters.clear();
+    addCounter(QStringLiteral("DeviceInfo"), DeviceInfo::instances(),
+               m_device->deviceObjects().size() + 1);
+    addCounter(QStringLiteral("ServiceInfo"), ServiceInfo::instances(),
+               m_device->serviceObjects().size() + (m_audit ? m_audit->serviceObjects() : 0));
+    addCounter(QStringLiteral("CharacteristicInfo"), CharacteristicInfo::instances(),
+               m_device->characteristicObjects().size());
+    addCounter(QStringLiteral("SampleSeries"), SampleSeries::instances(), 1);
+    addCounter(QStringLiteral("AuditJob"), AuditJob::instances(), -1);
+
+    // QLowEnergyService can't be instrumented, count every one reachable
+    // from the controllers instead. A service object which no listed
+    // ServiceInfo holds shows up as live above listed.
+    const int serviceObjects = m_device->lowEnergyServices()
+            + (m_audit ? m_audit->lowEnergyServices() : 0);
+    m_peakServiceObjects = qMax(m_peakServiceObjects, serviceObjects);
+    QVariantMap services;
+    services.insert("name", QStringLiteral("QLowEnergyService"));
+    services.insert("live", serviceObjects);
+    services.insert("peak", m_peakServiceObjects);
+    services.insert("created", -1);
+    services.insert("listed", m_device->serviceObjects().size()
+                    + (m_audit ? m_audit->serviceObjects() : 0));
+    m_counters.append(services);
+
+    m_characteristicBytes = valueBytes;
+    m_peakCharacteristicBytes = qMax(m_peakCharacteristicBytes, valueBytes);
+    m_historyBytes = historyBytes;
+    m_peakHistoryBytes = qMax(m_peakHistoryBytes, historyBytes);
+    m_droppedRecords = m_device->droppedRecords();
+    readProcessStatus();
+
+    emit updated();
+}
+
+void MemoryStats::addCounter(const QString &name, const InstanceCount &count, int listed)
+{
+    QVariantMap counter;
+    counter.insert("name", name);
+    counter.insert("live", count.live.load());
+    counter.insert("peak", count.peak.load());
+    counter.insert("created", count.created.load());
+    counter.insert("listed", listed);
+    m_counters.append(counter);
+}
+
+void MemoryStats::readProcessStatus()
+{
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    // lines look like "VmRSS:     12345 kB"
+    foreach (const QByteArray &line, status.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:"))
+            m_residentKb = line.mid(6).trimmed().split(' ').value(0).toLongLong();
+        else if (line.startsWith("VmHWM:"))
+            m_peakResidentKb = line.mid(6).trimmed().split(' ').value(0).toLongLong();
+    }
+}
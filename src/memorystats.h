@@ -0,0 +1,111 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVariant>
+
+class Device;
+class FleetAudit;
+struct InstanceCount;
+
+// Samples the live object counts of the data model classes and the bytes
+// held in characteristic values and history buffers while active. Objects
+// which are alive but no longer reachable from the device lists show up
+// as "unlisted", which is where leaks across rescans end up.
+class MemoryStats: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool active READ active WRITE setActive NOTIFY activeChanged)
+    Q_PROPERTY(QVariantList counters READ counters NOTIFY updated)
+    Q_PROPERTY(qint64 characteristicBytes READ characteristicBytes NOTIFY updated)
+    Q_PROPERTY(qint64 peakCharacteristicBytes READ peakCharacteristicBytes NOTIFY updated)
+    Q_PROPERTY(qint64 historyBytes READ historyBytes NOTIFY updated)
+    Q_PROPERTY(qint64 peakHistoryBytes READ peakHistoryBytes NOTIFY updated)
+    Q_PROPERTY(qint64 residentKb READ residentKb NOTIFY updated)
+    Q_PROPERTY(qint64 peakResidentKb READ peakResidentKb NOTIFY updated)
+    Q_PROPERTY(int droppedRecords READ droppedRecords NOTIFY updated)
+public:
+    explicit MemoryStats(Device *device, FleetAudit *audit = 0, QObject *parent = 0);
+
+    bool active() const;
+    void setActive(bool active);
+
+    // one map per class: name, live, peak, created and listed
+    QVariantList counters() const;
+    qint64 characteristicBytes() const;
+    qint64 peakCharacteristicBytes() const;
+    qint64 historyBytes() const;
+    qint64 peakHistoryBytes() const;
+    // -1 where /proc is not available
+    qint64 residentKb() const;
+    qint64 peakResidentKb() const;
+    // advertisements the discovery worker could not queue
+    int droppedRecords() const;
+
+    // one line summary, also written to the log
+    Q_INVOKABLE QString report();
+
+public slots:
+    void refresh();
+
+Q_SIGNALS:
+    void activeChanged();
+    void updated();
+
+private:
+    void addCounter(const QString &name, const InstanceCount &count, int listed);
+    void readProcessStatus();
+
+    Device *m_device;
+    FleetAudit *m_audit;
+    QTimer m_timer;
+    QVariantList m_counters;
+    int m_peakServiceObjects;
+    qint64 m_characteristicBytes;
+    qint64 m_peakCharacteristicBytes;
+    qint64 m_historyBytes;
+    qint64 m_peakHistoryBytes;
+    qint64 m_residentKb;
+    qint64 m_peakResidentKb;
+    int m_droppedRecords;
+};
+
+#endif // MEMORYSTATS_H
@@ -0,0 +1,432 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "peripheralemulator.h"
+#include "gattsnapshot.h"
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+#include <QtBluetooth/QLowEnergyAdvertisingData>
+#include <QtBluetooth/QLowEnergyAdvertisingParameters>
+#include <QtBluetooth/QLowEnergyCharacteristicData>
+#include <QtBluetooth/QLowEnergyDescriptorData>
+#include <QtBluetooth/QLowEnergyServiceData>
+#endif
+
+const char *PeripheralEmulator::testServiceUuid = "b1e50000-7a3c-4d7e-9f41-6c0de0b1e500";
+const char *PeripheralEmulator::streamCharacteristicUuid = "b1e50001-7a3c-4d7e-9f41-6c0de0b1e500";
+const char *PeripheralEmulator::sinkCharacteristicUuid = "b1e50002-7a3c-4d7e-9f41-6c0de0b1e500";
+const char *PeripheralEmulator::echoCharacteristicUuid = "b1e50003-7a3c-4d7e-9f41-6c0de0b1e500";
+
+namespace {
+
+// at most this many notifications are queued per timer tick, the stack
+// drops the rest anyway once its buffers are full
+const int maxBurst = 32;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+
+// snapshots store 16 and 32 bit UUIDs as "0x180f", others in full
+QBluetoothUuid parseUuid(const QString &uuid)
+{
+    if (uuid.startsWith(QLatin1String("0x"))) {
+        bool ok = false;
+        const quint32 value = uuid.mid(2).toUInt(&ok, 16);
+        if (ok && value <= 0xffff)
+            return QBluetoothUuid(quint16(value));
+        if (ok)
+            return QBluetoothUuid(value);
+    }
+    return QBluetoothUuid(uuid);
+}
+
+bool notificationsEnabled(const QLowEnergyCharacteristic &characteristic)
+{
+    const QLowEnergyDescriptor config =
+            characteristic.descriptor(QBluetoothUuid::ClientCharacteristicConfiguration);
+    return config.isValid() && !config.value().isEmpty() && (config.value().at(0) & 0x03);
+}
+
+QLowEnergyCharacteristicData characteristicData(const QBluetoothUuid &uuid, int properties)
+{
+    QLowEnergyCharacteristicData data;
+    data.setUuid(uuid);
+    data.setProperties(QLowEnergyCharacteristic::PropertyTypes(QFlag(properties)));
+    data.setValueLength(0, 512);
+    if (properties & (QLowEnergyCharacteristic::Notify | QLowEnergyCharacteristic::Indicate)) {
+        data.addDescriptor(QLowEnergyDescriptorData(QBluetoothUuid::ClientCharacteristicConfiguration,
+                                                    QByteArray(2, 0)));
+    }
+    return data;
+}
+
+#endif
+
+}
+
+PeripheralEmulator::PeripheralEmulator(QObject *parent):
+    QObject(parent), m_controller(0), m_testService(0),
+    m_localName(QStringLiteral("BLE Scanner peer")), m_connected(false),
+    m_notifyRate(50), m_payloadSize(20), m_notificationsSent(0), m_writesReceived(0),
+    m_bytesSent(0), m_bytesReceived(0), m_lastBytesSent(0), m_lastBytesReceived(0),
+    m_sendRate(0), m_receiveRate(0)
+{
+    m_notifyTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_notifyTimer, SIGNAL(timeout()), this, SLOT(sendNotifications()));
+    m_statisticsTimer.setInterval(1000);
+    connect(&m_statisticsTimer, SIGNAL(timeout()), this, SLOT(updateStatistics()));
+}
+
+PeripheralEmulator::~PeripheralEmulator()
+{
+    stop();
+}
+
+bool PeripheralEmulator::supported() const
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PeripheralEmulator::running() const
+{
+    return m_controller != 0;
+}
+
+bool PeripheralEmulator::centralConnected() const
+{
+    return m_connected;
+}
+
+int PeripheralEmulator::notifyRate() const
+{
+    return m_notifyRate;
+}
+
+void PeripheralEmulator::setNotifyRate(int rate)
+{
+    rate = qBound(0, rate, 1000);
+    if (rate == m_notifyRate)
+        return;
+
+    m_notifyRate = rate;
+    m_streamClock.restart();
+    m_notificationsSent = 0;
+    emit settingsChanged();
+}
+
+int PeripheralEmulator::payloadSize() const
+{
+    return m_payloadSize;
+}
+
+void PeripheralEmulator::setPayloadSize(int size)
+{
+    // the stack cuts notifications down to the negotiated ATT MTU - 3
+    size = qBound(1, size, 512);
+    if (size == m_payloadSize)
+        return;
+
+    m_payloadSize = size;
+    emit settingsChanged();
+}
+
+QString PeripheralEmulator::localName() const
+{
+    return m_localName;
+}
+
+void PeripheralEmulator::setLocalName(const QString &name)
+{
+    if (name == m_localName)
+        return;
+
+    m_localName = name;
+    emit settingsChanged();
+}
+
+qint64 PeripheralEmulator::notificationsSent() const
+{
+    return m_notificationsSent;
+}
+
+qint64 PeripheralEmulator::writesReceived() const
+{
+    return m_writesReceived;
+}
+
+double PeripheralEmulator::sendRate() const
+{
+    return m_sendRate;
+}
+
+double PeripheralEmulator::receiveRate() const
+{
+    return m_receiveRate;
+}
+
+QString PeripheralEmulator::startTestServer()
+{
+    return startServer(0);
+}
+
+QString PeripheralEmulator::startFromSnapshot(const QString &fileName)
+{
+    QString error;
+    const GattSnapshot snapshot = GattSnapshot::load(fileName, &error);
+    if (!error.isEmpty())
+        return QString("Cannot load %1: %2").arg(fileName, error);
+    if (snapshot.services.isEmpty())
+        return QStringLiteral("The snapshot has no services");
+
+    return startServer(&snapshot);
+}
+
+void PeripheralEmulator::stop()
+{
+    if (!m_controller)
+        return;
+
+    m_notifyTimer.stop();
+    m_statisticsTimer.stop();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+    m_controller->stopAdvertising();
+#endif
+    if (m_controller->state() != QLowEnergyController::UnconnectedState)
+        m_controller->disconnectFromDevice();
+
+    // the service objects are children of the controller
+    m_services.clear();
+    m_testService = 0;
+    m_controller->deleteLater();
+    m_controller = 0;
+    m_connected = false;
+    emit runningChanged();
+}
+
+QString PeripheralEmulator::startServer(const GattSnapshot *snapshot)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+    stop();
+    resetStatistics();
+
+    QList<QLowEnergyServiceData> services;
+    if (snapshot) {
+        foreach (const GattServiceEntry &entry, snapshot->services) {
+            QLowEnergyServiceData service;
+            service.setType((entry.type & QLowEnergyService::PrimaryService)
+                            ? QLowEnergyServiceData::ServiceTypePrimary
+                            : QLowEnergyServiceData::ServiceTypeSecondary);
+            service.setUuid(parseUuid(entry.uuid));
+            foreach (const GattCharacteristicEntry &ch, entry.characteristics)
+                service.addCharacteristic(characteristicData(parseUuid(ch.uuid), ch.properties));
+            services.append(service);
+        }
+    } else {
+        QLowEnergyServiceData service;
+        service.setType(QLowEnergyServiceData::ServiceTypePrimary);
+        service.setUuid(QBluetoothUuid(QString::fromLatin1(testServiceUuid)));
+        service.addCharacteristic(characteristicData(QBluetoothUuid(QString::fromLatin1(streamCharacteristicUuid)),
+                                                     QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Notify));
+        service.addCharacteristic(characteristicData(QBluetoothUuid(QString::fromLatin1(sinkCharacteristicUuid)),
+                                                     QLowEnergyCharacteristic::Write | QLowEnergyCharacteristic::WriteNoResponse));
+        service.addCharacteristic(characteristicData(QBluetoothUuid(QString::fromLatin1(echoCharacteristicUuid)),
+                                                     QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Notify));
+        services.append(service);
+    }
+
+    m_controller = QLowEnergyController::createPeripheral(this);
+    connect(m_controller, SIGNAL(connected()), this, SLOT(centralConnectedChanged()));
+    connect(m_controller, SIGNAL(disconnected()), this, SLOT(centralConnectedChanged()));
+    connect(m_controller, SIGNAL(error(QLowEnergyController::Error)),
+            this, SLOT(controllerError(QLowEnergyController::Error)));
+
+    foreach (const QLowEnergyServiceData &data, services) {
+        if (!data.isValid()) {
+            qWarning() << "Skipping invalid service" << data.uuid();
+            continue;
+        }
+        QLowEnergyService *service = m_controller->addService(data, m_controller);
+        if (!service)
+            continue;
+        connect(service, SIGNAL(characteristicChanged(QLowEnergyCharacteristic,QByteArray)),
+                this, SLOT(characteristicWritten(QLowEnergyCharacteristic,QByteArray)));
+        m_services.append(service);
+    }
+
+    if (m_services.isEmpty()) {
+        stop();
+        return QStringLiteral("No service could be added");
+    }
+
+    if (!snapshot)
+        m_testService = m_services.first();
+    m_advertisedService = services.first().uuid().toString();
+    startAdvertising();
+    m_statisticsTimer.start();
+    emit runningChanged();
+
+    return QString("Advertising %1 services as \"%2\"").arg(m_services.size()).arg(m_localName);
+#else
+    Q_UNUSED(snapshot);
+    return QStringLiteral("Peripheral mode needs Qt 5.7 or later");
+#endif
+}
+
+void PeripheralEmulator::startAdvertising()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+    // a 128 bit UUID leaves too little room for the name in the 31 byte
+    // advertisement, the name goes into the scan response
+    QLowEnergyAdvertisingData advertising;
+    advertising.setDiscoverability(QLowEnergyAdvertisingData::DiscoverabilityGeneral);
+    advertising.setServices(QList<QBluetoothUuid>() << QBluetoothUuid(m_advertisedService));
+    QLowEnergyAdvertisingData response;
+    response.setLocalName(m_localName);
+
+    m_controller->startAdvertising(QLowEnergyAdvertisingParameters(), advertising, response);
+#endif
+}
+
+void PeripheralEmulator::centralConnectedChanged()
+{
+    if (!m_controller)
+        return;
+
+    m_connected = m_controller->state() == QLowEnergyController::ConnectedState;
+    if (m_connected) {
+        qInfo() << "Central connected:" << m_controller->remoteAddress().toString();
+        resetStatistics();
+        m_streamClock.start();
+        if (m_testService)
+            m_notifyTimer.start(10);
+    } else {
+        // advertising stops with the connection, become visible again
+        m_notifyTimer.stop();
+        startAdvertising();
+    }
+    emit runningChanged();
+}
+
+void PeripheralEmulator::controllerError(QLowEnergyController::Error error)
+{
+    qWarning() << "Peripheral error" << error << m_controller->errorString();
+    stop();
+}
+
+void PeripheralEmulator::characteristicWritten(const QLowEnergyCharacteristic &characteristic,
+                                               const QByteArray &value)
+{
+    ++m_writesReceived;
+    m_bytesReceived += value.size();
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+    if (!m_testService
+            || characteristic.uuid() != QBluetoothUuid(QString::fromLatin1(sinkCharacteristicUuid)))
+        return;
+
+    const QLowEnergyCharacteristic echo =
+            m_testService->characteristic(QBluetoothUuid(QString::fromLatin1(echoCharacteristicUuid)));
+    if (notificationsEnabled(echo)) {
+        m_testService->writeCharacteristic(echo, value);
+        m_bytesSent += value.size();
+    }
+#else
+    Q_UNUSED(characteristic);
+#endif
+}
+
+void PeripheralEmulator::sendNotifications()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 7, 0)
+    if (!m_testService || m_notifyRate == 0)
+        return;
+
+    const QLowEnergyCharacteristic stream =
+            m_testService->characteristic(QBluetoothUuid(QString::fromLatin1(streamCharacteristicUuid)));
+    if (!notificationsEnabled(stream)) {
+        // start counting once the central subscribes
+        m_streamClock.restart();
+        m_notificationsSent = 0;
+        return;
+    }
+
+    // every payload starts with a sequence number and the milliseconds
+    // since the stream started, both little endian, so the receiver can
+    // count losses and measure latency
+    const qint64 due = m_streamClock.elapsed() * m_notifyRate / 1000;
+    QByteArray payload(m_payloadSize, 0);
+    uchar header[8];
+    for (int burst = 0; m_notificationsSent < due && burst < maxBurst; ++burst) {
+        qToLittleEndian<quint32>(quint32(m_notificationsSent), header);
+        qToLittleEndian<quint32>(quint32(m_streamClock.elapsed()), header + 4);
+        memcpy(payload.data(), header, qMin(m_payloadSize, 8));
+
+        m_testService->writeCharacteristic(stream, payload);
+        ++m_notificationsSent;
+        m_bytesSent += payload.size();
+    }
+#endif
+}
+
+void PeripheralEmulator::updateStatistics()
+{
+    const double seconds = m_statisticsTimer.interval() / 1000.0;
+    m_sendRate = (m_bytesSent - m_lastBytesSent) / seconds;
+    m_receiveRate = (m_bytesReceived - m_lastBytesReceived) / seconds;
+    m_lastBytesSent = m_bytesSent;
+    m_lastBytesReceived = m_bytesReceived;
+    emit statisticsChanged();
+}
+
+void PeripheralEmulator::resetStatistics()
+{
+    m_notificationsSent = 0;
+    m_writesReceived = 0;
+    m_bytesSent = 0;
+    m_bytesReceived = 0;
+    m_lastBytesSent = 0;
+    m_lastBytesReceived = 0;
+    m_sendRate = 0;
+    m_receiveRate = 0;
+    emit statisticsChanged();
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef PERIPHERALEMULATOR_H
+#define PERIPHERALEMULATOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QTimer>
+#include <QtBluetooth/QLowEnergyController>
+#include <QtBluetooth/QLowEnergyService>
+
+struct GattSnapshot;
+
+// Runs the local adapter as a GATT server, either with a test service or
+// with the layout of a saved GATT snapshot. The test service streams
+// notifications of payloadSize bytes at notifyRate per second, accepts
+// writes on its sink characteristic and echoes every write back as a
+// notification, so a second unit can measure throughput and latency.
+// Peripheral mode needs Qt 5.7, supported is false before that.
+class PeripheralEmulator: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool supported READ supported CONSTANT)
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(bool centralConnected READ centralConnected NOTIFY runningChanged)
+    Q_PROPERTY(int notifyRate READ notifyRate WRITE setNotifyRate NOTIFY settingsChanged)
+    Q_PROPERTY(int payloadSize READ payloadSize WRITE setPayloadSize NOTIFY settingsChanged)
+    Q_PROPERTY(QString localName READ localName WRITE setLocalName NOTIFY settingsChanged)
+    Q_PROPERTY(qint64 notificationsSent READ notificationsSent NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 writesReceived READ writesReceived NOTIFY statisticsChanged)
+    Q_PROPERTY(double sendRate READ sendRate NOTIFY statisticsChanged)
+    Q_PROPERTY(double receiveRate READ receiveRate NOTIFY statisticsChanged)
+public:
+    // UUIDs of the test service, the central side looks for these
+    static const char *testServiceUuid;
+    static const char *streamCharacteristicUuid;
+    static const char *sinkCharacteristicUuid;
+    static const char *echoCharacteristicUuid;
+
+    explicit PeripheralEmulator(QObject *parent = 0);
+    ~PeripheralEmulator();
+
+    bool supported() const;
+    bool running() const;
+    bool centralConnected() const;
+    int notifyRate() const;
+    void setNotifyRate(int rate);
+    int payloadSize() const;
+    void setPayloadSize(int size);
+    QString localName() const;
+    void setLocalName(const QString &name);
+    qint64 notificationsSent() const;
+    qint64 writesReceived() const;
+    // bytes per second over the last statistics interval
+    double sendRate() const;
+    double receiveRate() const;
+
+    // the return values are status messages suitable for the UI
+    Q_INVOKABLE QString startTestServer();
+    Q_INVOKABLE QString startFromSnapshot(const QString &fileName);
+    Q_INVOKABLE void stop();
+
+Q_SIGNALS:
+    void runningChanged();
+    void settingsChanged();
+    void statisticsChanged();
+
+private slots:
+    void centralConnectedChanged();
+    void controllerError(QLowEnergyController::Error error);
+    void characteristicWritten(const QLowEnergyCharacteristic &characteristic,
+                               const QByteArray &value);
+    void sendNotifications();
+    void updateStatistics();
+
+private:
+    QString startServer(const GattSnapshot *snapshot);
+    void startAdvertising();
+    void resetStatistics();
+
+    QLowEnergyController *m_controller;
+    QList<QLowEnergyService*> m_services;
+    // the test service if it is running, owned by m_controller
+    QLowEnergyService *m_testService;
+    QTimer m_notifyTimer;
+    QTimer m_statisticsTimer;
+    QElapsedTimer m_streamClock;
+    QString m_advertisedService;
+    QString m_localName;
+    bool m_connected;
+    int m_notifyRate;
+    int m_payloadSize;
+    qint64 m_notificationsSent;
+    qint64 m_writesReceived;
+    qint64 m_bytesSent;
+    qint64 m_bytesReceived;
+    qint64 m_lastBytesSent;
+    qint64 m_lastBytesReceived;
+    double m_sendRate;
+    double m_receiveRate;
+};
+
+#endif // PERIPHERALEMULATOR_H
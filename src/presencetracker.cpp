@@ -0,0 +1,201 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "presencetracker.h"
+#include <QDateTime>
+#include <QStringList>
+#include <algorithm>
+#include <climits>
+
+PresenceTracker::PresenceTracker(QObject *parent):
+    QObject(parent), m_timeout(120000)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(expire()));
+}
+
+int PresenceTracker::timeout() const
+{
+    return m_timeout;
+}
+
+void PresenceTracker::setTimeout(int msecs)
+{
+    if (msecs == m_timeout)
+        return;
+
+    m_timeout = msecs;
+    rebuildHeap();
+    emit timeoutChanged();
+    expire();
+}
+
+int PresenceTracker::count() const
+{
+    return m_entries.size();
+}
+
+bool PresenceTracker::seen(const QString &address, qint64 now)
+{
+    QHash<QString, PresenceEntry>::iterator it = m_entries.find(address);
+    if (it != m_entries.end()) {
+        // the pending deadline is pushed back lazily when it fires
+        it->lastSeen = now;
+        it->seenCount++;
+        return false;
+    }
+
+    PresenceEntry entry;
+    entry.firstSeen = now;
+    entry.lastSeen = now;
+    entry.seenCount = 1;
+    m_entries.insert(address, entry);
+    push(now + m_timeout, address);
+    arm(now);
+
+    emit countChanged();
+    emit deviceEntered(address);
+    return true;
+}
+
+bool PresenceTracker::contains(const QString &address) const
+{
+    return m_entries.contains(address);
+}
+
+PresenceEntry PresenceTracker::entry(const QString &address) const
+{
+    PresenceEntry empty = { 0, 0, 0 };
+    return m_entries.value(address, empty);
+}
+
+const QHash<QString, PresenceEntry> &PresenceTracker::entries() const
+{
+    return m_entries;
+}
+
+void PresenceTracker::clear()
+{
+    m_timer.stop();
+    m_heap.clear();
+    m_entries.clear();
+    emit countChanged();
+}
+
+qint64 PresenceTracker::firstSeen(const QString &address) const
+{
+    return entry(address).firstSeen;
+}
+
+qint64 PresenceTracker::lastSeen(const QString &address) const
+{
+    return entry(address).lastSeen;
+}
+
+int PresenceTracker::seenCount(const QString &address) const
+{
+    return entry(address).seenCount;
+}
+
+void PresenceTracker::expire()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QStringList left;
+
+    while (!m_heap.isEmpty() && m_heap.first().when <= now) {
+        std::pop_heap(m_heap.begin(), m_heap.end());
+        const Deadline due = m_heap.takeLast();
+
+        QHash<QString, PresenceEntry>::iterator it = m_entries.find(due.address);
+        if (it == m_entries.end())
+            continue;
+
+        const qint64 deadline = it->lastSeen + m_timeout;
+        if (deadline > now) {
+            // seen again since this deadline was scheduled
+            push(deadline, due.address);
+            continue;
+        }
+
+        m_entries.erase(it);
+        left.append(due.address);
+    }
+
+    arm(now);
+
+    if (left.isEmpty())
+        return;
+
+    emit countChanged();
+    foreach (const QString &address, left)
+        emit deviceLeft(address);
+}
+
+void PresenceTracker::push(qint64 when, const QString &address)
+{
+    Deadline deadline;
+    deadline.when = when;
+    deadline.address = address;
+    m_heap.append(deadline);
+    std::push_heap(m_heap.begin(), m_heap.end());
+}
+
+void PresenceTracker::rebuildHeap()
+{
+    m_heap.clear();
+    m_heap.reserve(m_entries.size());
+    QHash<QString, PresenceEntry>::const_iterator it = m_entries.constBegin();
+    for (; it != m_entries.constEnd(); ++it) {
+        Deadline deadline;
+        deadline.when = it->lastSeen + m_timeout;
+        deadline.address = it.key();
+        m_heap.append(deadline);
+    }
+    std::make_heap(m_heap.begin(), m_heap.end());
+}
+
+void PresenceTracker::arm(qint64 now)
+{
+    if (m_heap.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+
+    const qint64 wait = qMax<qint64>(0, m_heap.first().when - now);
+    if (!m_timer.isActive() || m_timer.remainingTime() > wait)
+        m_timer.start(int(qMin<qint64>(wait, INT_MAX)));
+}
@@ -0,0 +1,108 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef PRESENCETRACKER_H
+#define PRESENCETRACKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+struct PresenceEntry
+{
+    qint64 firstSeen;
+    qint64 lastSeen;
+    int seenCount;
+};
+
+// Keeps a presence table of every address reported by discovery and ages
+// entries out once they have not been seen for timeout() milliseconds.
+// Expiry deadlines live in a min-heap holding one deadline per entry, so a
+// tick only looks at the entries that are actually due.
+class PresenceTracker: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+public:
+    explicit PresenceTracker(QObject *parent = 0);
+
+    int timeout() const;
+    void setTimeout(int msecs);
+    int count() const;
+
+    // returns true if the address was not present before
+    bool seen(const QString &address, qint64 now);
+    bool contains(const QString &address) const;
+    PresenceEntry entry(const QString &address) const;
+    const QHash<QString, PresenceEntry> &entries() const;
+    void clear();
+
+    Q_INVOKABLE qint64 firstSeen(const QString &address) const;
+    Q_INVOKABLE qint64 lastSeen(const QString &address) const;
+    Q_INVOKABLE int seenCount(const QString &address) const;
+
+Q_SIGNALS:
+    void deviceEntered(const QString &address);
+    void deviceLeft(const QString &address);
+    void timeoutChanged();
+    void countChanged();
+
+private slots:
+    void expire();
+
+private:
+    struct Deadline
+    {
+        qint64 when;
+        QString address;
+        bool operator<(const Deadline &other) const { return when > other.when; }
+    };
+
+    void push(qint64 when, const QString &address);
+    void rebuildHeap();
+    void arm(qint64 now);
+
+    QHash<QString, PresenceEntry> m_entries;
+    QVector<Deadline> m_heap;
+    QTimer m_timer;
+    int m_timeout;
+};
+
+#endif // PRESENCETRACKER_H
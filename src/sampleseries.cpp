@@ -0,0 +1,139 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "sampleseries.h"
+#include <limits>
+
+SampleSeries::SampleSeries(int capacity, QObject *parent):
+    QObject(parent), m_total(0)
+{
+    // keep whole blocks so that block summaries never straddle the wrap
+    const int blocks = qMax(1, (capacity + blockSize - 1) / blockSize);
+    m_samples.resize(blocks * blockSize);
+    m_blockMin.resize(blocks);
+    m_blockMax.resize(blocks);
+}
+
+int SampleSeries::count() const
+{
+    return int(qMin<qint64>(m_total, m_samples.size()));
+}
+
+int SampleSeries::capacity() const
+{
+    return m_samples.size();
+}
+
+double SampleSeries::last() const
+{
+    if (m_total == 0)
+        return 0;
+    return m_samples.at(int((m_total - 1) % m_samples.size()));
+}
+
+qint64 SampleSeries::memoryUsage() const
+{
+    return qint64(m_samples.capacity() + m_blockMin.capacity() + m_blockMax.capacity())
+            * sizeof(double);
+}
+
+void SampleSeries::append(double value)
+{
+    const int index = int(m_total % m_samples.size());
+    const int block = index / blockSize;
+    m_samples[index] = value;
+
+    if (index % blockSize == 0) {
+        m_blockMin[block] = value;
+        m_blockMax[block] = value;
+    } else {
+        m_blockMin[block] = qMin(m_blockMin.at(block), value);
+        m_blockMax[block] = qMax(m_blockMax.at(block), value);
+    }
+
+    m_total++;
+    emit samplesChanged();
+}
+
+void SampleSeries::clear()
+{
+    m_total = 0;
+    emit samplesChanged();
+}
+
+void SampleSeries::minMax(int first, int length, int buckets, QVector<double> *minimum,
+                          QVector<double> *maximum) const
+{
+    minimum->resize(buckets);
+    maximum->resize(buckets);
+    if (buckets <= 0 || length <= 0)
+        return;
+
+    const qint64 start = m_total - count() + first;
+    for (int i = 0; i < buckets; i++) {
+        const qint64 from = start + qint64(i) * length / buckets;
+        const qint64 to = qMax(from + 1, start + qint64(i + 1) * length / buckets);
+        rangeMinMax(from, to, &(*minimum)[i], &(*maximum)[i]);
+    }
+}
+
+void SampleSeries::rangeMinMax(qint64 from, qint64 to, double *minimum, double *maximum) const
+{
+    double low = std::numeric_limits<double>::max();
+    double high = -std::numeric_limits<double>::max();
+    const int size = m_samples.size();
+
+    qint64 i = from;
+    while (i < to) {
+        const int index = int(i % size);
+        // a whole block inside the range is read from its summary, the
+        // block holding the newest sample may be partial and is scanned
+        if (index % blockSize == 0 && i + blockSize <= to && i + blockSize <= m_total) {
+            const int block = index / blockSize;
+            low = qMin(low, m_blockMin.at(block));
+            high = qMax(high, m_blockMax.at(block));
+            i += blockSize;
+        } else {
+            low = qMin(low, m_samples.at(index));
+            high = qMax(high, m_samples.at(index));
+            i++;
+        }
+    }
+
+    *minimum = low;
+    *maximum = high;
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SAMPLESERIES_H
+#define SAMPLESERIES_H
+
+#include <QObject>
+#include <QVector>
+#include "instancecounter.h"
+
+// Fixed size history of numeric samples. Every block of blockSize
+// samples also keeps its minimum and maximum, so a range can be reduced
+// to min/max buckets mostly from the block summaries instead of
+// touching every sample.
+class SampleSeries: public QObject, public InstanceCounted<SampleSeries>
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY samplesChanged)
+    Q_PROPERTY(double last READ last NOTIFY samplesChanged)
+public:
+    enum { blockSize = 64 };
+
+    explicit SampleSeries(int capacity = 65536, QObject *parent = 0);
+
+    int count() const;
+    int capacity() const;
+    double last() const;
+    // bytes held by the sample buffer and the block summaries
+    qint64 memoryUsage() const;
+
+    void append(double value);
+    void clear();
+
+    // reduces the samples [first, first + length) of the current history
+    // into buckets, writing their minimum and maximum values
+    void minMax(int first, int length, int buckets, QVector<double> *minimum,
+                QVector<double> *maximum) const;
+
+Q_SIGNALS:
+    void samplesChanged();
+
+private:
+    void rangeMinMax(qint64 from, qint64 to, double *minimum, double *maximum) const;
+
+    QVector<double> m_samples;
+    QVector<double> m_blockMin;
+    QVector<double> m_blockMax;
+    // number of samples ever appended, the oldest kept one is
+    // m_total - count()
+    qint64 m_total;
+};
+
+#endif // SAMPLESERIES_H
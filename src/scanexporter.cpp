@@ -0,0 +1,310 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scanexporter.h"
+#include "streamwriter.h"
+#include "device.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+ScanExporter::ScanExporter(Device *device, QObject *parent):
+    QObject(parent), m_device(device)
+{
+}
+
+QString ScanExporter::lastFile() const
+{
+    return m_lastFile;
+}
+
+QString ScanExporter::exportDevices(const QString &format)
+{
+    if (!isSupported(format))
+        return QString("Export failed: unknown format %1").arg(format);
+
+    QFile file;
+    if (!open(file, QStringLiteral("devices"), format))
+        return QString("Export failed: %1").arg(file.errorString());
+
+    bool error;
+    if (format == QLatin1String("csv")) {
+        CsvWriter writer(&file);
+        writeDevices(writer);
+        error = writer.hasError();
+    } else {
+        JsonWriter writer(&file);
+        writeDevices(writer);
+        error = writer.hasError();
+    }
+    return finish(file, error);
+}
+
+QString ScanExporter::exportPresence(const QString &format)
+{
+    if (!isSupported(format))
+        return QString("Export failed: unknown format %1").arg(format);
+
+    QFile file;
+    if (!open(file, QStringLiteral("presence"), format))
+        return QString("Export failed: %1").arg(file.errorString());
+
+    bool error;
+    if (format == QLatin1String("csv")) {
+        CsvWriter writer(&file);
+        writePresence(writer);
+        error = writer.hasError();
+    } else {
+        JsonWriter writer(&file);
+        writePresence(writer);
+        error = writer.hasError();
+    }
+    return finish(file, error);
+}
+
+QString ScanExporter::exportGattTree(const QString &format)
+{
+    if (m_device->serviceObjects().isEmpty())
+        return QStringLiteral("Nothing to export, no services discovered");
+
+    if (!isSupported(format))
+        return QString("Export failed: unknown format %1").arg(format);
+
+    QFile file;
+    if (!open(file, QStringLiteral("gatt"), format))
+        return QString("Export failed: %1").arg(file.errorString());
+
+    bool error;
+    if (format == QLatin1String("csv")) {
+        CsvWriter writer(&file);
+        writeGattTree(writer);
+        error = writer.hasError();
+    } else {
+        JsonWriter writer(&file);
+        writeGattTree(writer);
+        error = writer.hasError();
+    }
+    return finish(file, error);
+}
+
+bool ScanExporter::isSupported(const QString &format)
+{
+    return format == QLatin1String("csv") || format == QLatin1String("json");
+}
+
+bool ScanExporter::open(QFile &file, const QString &kind, const QString &format)
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    QDir().mkpath(dir);
+
+    const QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss");
+    file.setFileName(QString("%1/ble_scanner-%2-%3.%4").arg(dir, kind, stamp, format));
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+QString ScanExporter::finish(QFile &file, bool error)
+{
+    file.close();
+    if (error || file.error() != QFile::NoError) {
+        qWarning() << "Export failed:" << file.fileName() << file.errorString();
+        return QString("Export failed: %1").arg(file.errorString());
+    }
+
+    m_lastFile = file.fileName();
+    emit exported(m_lastFile);
+    return QString("Exported to %1").arg(m_lastFile);
+}
+
+void ScanExporter::writeDevices(CsvWriter &writer)
+{
+    writer.writeRow(QStringList() << "address" << "name" << "rssi"
+                    << "service_uuids" << "manufacturer_data");
+
+    foreach (QObject *object, m_device->deviceObjects()) {
+        const DeviceInfo *d = (DeviceInfo*)object;
+        writer.writeRow(QStringList() << d->getAddress() << d->getName()
+                        << QString::number(d->getRssi())
+                        << d->getServiceUuids().join(QLatin1Char(' '))
+                        << d->getManufacturerData());
+    }
+}
+
+void ScanExporter::writeDevices(JsonWriter &writer)
+{
+    writer.beginArray();
+    foreach (QObject *object, m_device->deviceObjects()) {
+        const DeviceInfo *d = (DeviceInfo*)object;
+        writer.beginObject();
+        writer.name("address");
+        writer.value(d->getAddress());
+        writer.name("name");
+        writer.value(d->getName());
+        writer.name("rssi");
+        writer.value(qint64(d->getRssi()));
+        writer.name("serviceUuids");
+        writer.beginArray();
+        foreach (const QString &uuid, d->getServiceUuids())
+            writer.value(uuid);
+        writer.endArray();
+        writer.name("manufacturerData");
+        writer.value(d->getManufacturerData());
+        writer.endObject();
+    }
+    writer.endArray();
+}
+
+void ScanExporter::writePresence(CsvWriter &writer)
+{
+    writer.writeRow(QStringList() << "address" << "first_seen" << "last_seen" << "seen_count");
+
+    const QHash<QString, PresenceEntry> &entries = m_device->presence()->entries();
+    QHash<QString, PresenceEntry>::const_iterator it = entries.constBegin();
+    for (; it != entries.constEnd(); ++it) {
+        writer.writeRow(QStringList() << it.key()
+                        << QDateTime::fromMSecsSinceEpoch(it->firstSeen).toString(Qt::ISODate)
+                        << QDateTime::fromMSecsSinceEpoch(it->lastSeen).toString(Qt::ISODate)
+                        << QString::number(it->seenCount));
+    }
+}
+
+void ScanExporter::writePresence(JsonWriter &writer)
+{
+    writer.beginArray();
+    const QHash<QString, PresenceEntry> &entries = m_device->presence()->entries();
+    QHash<QString, PresenceEntry>::const_iterator it = entries.constBegin();
+    for (; it != entries.constEnd(); ++it) {
+        writer.beginObject();
+        writer.name("address");
+        writer.value(it.key());
+        writer.name("firstSeen");
+        writer.value(QDateTime::fromMSecsSinceEpoch(it->firstSeen).toString(Qt::ISODate));
+        writer.name("lastSeen");
+        writer.value(QDateTime::fromMSecsSinceEpoch(it->lastSeen).toString(Qt::ISODate));
+        writer.name("seenCount");
+        writer.value(qint64(it->seenCount));
+        writer.endObject();
+    }
+    writer.endArray();
+}
+
+void ScanExporter::writeGattTree(CsvWriter &writer)
+{
+    writer.writeRow(QStringList() << "service_uuid" << "service_name" << "characteristic_uuid"
+                    << "characteristic_name" << "handle" << "properties" << "value");
+
+    foreach (QObject *object, m_device->serviceObjects()) {
+        const ServiceInfo *s = (ServiceInfo*)object;
+        const QList<QLowEnergyCharacteristic> chars = s->service()->characteristics();
+        if (chars.isEmpty()) {
+            // details of this service were never discovered
+            writer.writeRow(QStringList() << s->getUuid() << s->getName()
+                            << QString() << QString() << QString() << QString() << QString());
+            continue;
+        }
+
+        foreach (const QLowEnergyCharacteristic &ch, chars) {
+            writer.writeRow(QStringList() << s->getUuid() << s->getName()
+                            << CharacteristicInfo::uuidOf(ch) << CharacteristicInfo::nameOf(ch)
+                            << CharacteristicInfo::handleOf(ch)
+                            << CharacteristicInfo::propertyNames(ch.properties()).join(QLatin1Char(' '))
+                            << QString::fromLatin1(ch.value().toHex()));
+        }
+    }
+}
+
+void ScanExporter::writeGattTree(JsonWriter &writer)
+{
+    const DeviceInfo *current = m_device->connectedDevice();
+
+    writer.beginObject();
+    writer.name("address");
+    writer.value(current->getAddress());
+    writer.name("name");
+    writer.value(current->getName());
+    writer.name("services");
+    writer.beginArray();
+    foreach (QObject *object, m_device->serviceObjects()) {
+        const ServiceInfo *s = (ServiceInfo*)object;
+        writer.beginObject();
+        writer.name("uuid");
+        writer.value(s->getUuid());
+        writer.name("name");
+        writer.value(s->getName());
+        writer.name("type");
+        writer.value(s->getType());
+        writer.name("characteristics");
+        writer.beginArray();
+        foreach (const QLowEnergyCharacteristic &ch, s->service()->characteristics()) {
+            writer.beginObject();
+            writer.name("uuid");
+            writer.value(CharacteristicInfo::uuidOf(ch));
+            writer.name("name");
+            writer.value(CharacteristicInfo::nameOf(ch));
+            writer.name("handle");
+            writer.value(qint64(ch.handle()));
+            writer.name("properties");
+            writer.beginArray();
+            foreach (const QString &property, CharacteristicInfo::propertyNames(ch.properties()))
+                writer.value(property);
+            writer.endArray();
+            writer.name("value");
+            writer.value(QString::fromLatin1(ch.value().toHex()));
+            writer.name("descriptors");
+            writer.beginArray();
+            foreach (const QLowEnergyDescriptor &descriptor, ch.descriptors()) {
+                writer.beginObject();
+                writer.name("uuid");
+                writer.value(descriptor.uuid().toString().remove(QLatin1Char('{')).remove(QLatin1Char('}')));
+                writer.name("name");
+                writer.value(descriptor.name());
+                writer.name("handle");
+                writer.value(qint64(descriptor.handle()));
+                writer.name("value");
+                writer.value(QString::fromLatin1(descriptor.value().toHex()));
+                writer.endObject();
+            }
+            writer.endArray();
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
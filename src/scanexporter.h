@@ -0,0 +1,86 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SCANEXPORTER_H
+#define SCANEXPORTER_H
+
+#include <QObject>
+#include <QString>
+
+QT_FORWARD_DECLARE_CLASS(QFile)
+
+class Device;
+class CsvWriter;
+class JsonWriter;
+
+// Writes the device list, the presence table and the GATT tree of the
+// connected device to CSV or JSON files in the documents folder.
+class ScanExporter: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString lastFile READ lastFile NOTIFY exported)
+public:
+    explicit ScanExporter(Device *device, QObject *parent = 0);
+
+    QString lastFile() const;
+
+    // format is either "csv" or "json", the return value is a status
+    // message suitable for the UI
+    Q_INVOKABLE QString exportDevices(const QString &format);
+    Q_INVOKABLE QString exportPresence(const QString &format);
+    Q_INVOKABLE QString exportGattTree(const QString &format);
+
+Q_SIGNALS:
+    void exported(const QString &fileName);
+
+private:
+    static bool isSupported(const QString &format);
+    bool open(QFile &file, const QString &kind, const QString &format);
+    QString finish(QFile &file, bool error);
+
+    void writeDevices(CsvWriter &writer);
+    void writeDevices(JsonWriter &writer);
+    void writePresence(CsvWriter &writer);
+    void writePresence(JsonWriter &writer);
+    void writeGattTree(CsvWriter &writer);
+    void writeGattTree(JsonWriter &writer);
+
+    Device *m_device;
+    QString m_lastFile;
+};
+
+#endif // SCANEXPORTER_H
@@ -0,0 +1,264 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scanscheduler.h"
+#include "device.h"
+#include <ctime>
+
+namespace {
+const qint64 msecsPerHour = 3600 * 1000;
+
+// below this fraction of devices appearing or disappearing between two
+// windows the environment is considered stable
+const qreal stableChangeRate = 0.1;
+const qreal busyChangeRate = 0.3;
+
+double processCpuSeconds()
+{
+    return double(std::clock()) / CLOCKS_PER_SEC;
+}
+}
+
+ScanScheduler::ScanScheduler(Device *device, QObject *parent):
+    QObject(parent), m_device(device), m_enabled(false), m_adaptive(true),
+    m_paused(false), m_inWindow(false), m_scanWindow(10000), m_minScanWindow(2000),
+    m_scanInterval(60000), m_currentWindow(10000), m_scanCurrent(12.0),
+    m_changeRate(0), m_radioTime(0), m_cpuStart(0)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(timeout()));
+    connect(m_device, SIGNAL(deviceSeen(QString)), this, SLOT(deviceSeen(QString)));
+}
+
+bool ScanScheduler::isEnabled() const
+{
+    return m_enabled;
+}
+
+void ScanScheduler::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    if (m_enabled) {
+        m_currentWindow = m_scanWindow;
+        m_changeRate = 0;
+        m_radioTime = 0;
+        m_previousSeen.clear();
+        m_runTime.start();
+        m_cpuStart = processCpuSeconds();
+        if (!m_paused)
+            beginWindow();
+    } else {
+        m_timer.stop();
+        if (m_inWindow)
+            endWindow();
+    }
+    emit enabledChanged();
+    emit statisticsChanged();
+}
+
+void ScanScheduler::setPaused(bool paused)
+{
+    if (m_paused == paused)
+        return;
+
+    m_paused = paused;
+    if (!m_enabled)
+        return;
+
+    m_timer.stop();
+    if (m_paused) {
+        if (m_inWindow)
+            endWindow();
+    } else {
+        beginWindow();
+    }
+}
+
+bool ScanScheduler::isAdaptive() const
+{
+    return m_adaptive;
+}
+
+void ScanScheduler::setAdaptive(bool adaptive)
+{
+    m_adaptive = adaptive;
+    if (!m_adaptive)
+        m_currentWindow = m_scanWindow;
+    emit settingsChanged();
+}
+
+int ScanScheduler::scanWindow() const
+{
+    return m_scanWindow;
+}
+
+void ScanScheduler::setScanWindow(int window)
+{
+    m_scanWindow = qBound(m_minScanWindow, window, m_scanInterval);
+    m_currentWindow = qMin(m_currentWindow, m_scanWindow);
+    emit settingsChanged();
+}
+
+int ScanScheduler::minScanWindow() const
+{
+    return m_minScanWindow;
+}
+
+void ScanScheduler::setMinScanWindow(int window)
+{
+    m_minScanWindow = qBound(500, window, m_scanWindow);
+    m_currentWindow = qMax(m_currentWindow, m_minScanWindow);
+    emit settingsChanged();
+}
+
+int ScanScheduler::scanInterval() const
+{
+    return m_scanInterval;
+}
+
+void ScanScheduler::setScanInterval(int interval)
+{
+    m_scanInterval = qMax(interval, m_scanWindow);
+    emit settingsChanged();
+}
+
+qreal ScanScheduler::scanCurrent() const
+{
+    return m_scanCurrent;
+}
+
+void ScanScheduler::setScanCurrent(qreal current)
+{
+    m_scanCurrent = current;
+    emit settingsChanged();
+    emit statisticsChanged();
+}
+
+int ScanScheduler::currentWindow() const
+{
+    return m_currentWindow;
+}
+
+qreal ScanScheduler::changeRate() const
+{
+    return m_changeRate;
+}
+
+qreal ScanScheduler::dutyCycle() const
+{
+    // measured once some windows ran, configured until then
+    if (m_enabled && m_runTime.elapsed() > m_scanInterval)
+        return qreal(m_radioTime) / m_runTime.elapsed();
+    return qreal(m_currentWindow) / m_scanInterval;
+}
+
+qreal ScanScheduler::batteryPerHour() const
+{
+    return dutyCycle() * m_scanCurrent;
+}
+
+qreal ScanScheduler::cpuPerHour() const
+{
+    if (!m_enabled || m_runTime.elapsed() <= 0)
+        return 0;
+
+    const double used = processCpuSeconds() - m_cpuStart;
+    return used * msecsPerHour / m_runTime.elapsed();
+}
+
+void ScanScheduler::timeout()
+{
+    if (m_inWindow)
+        endWindow();
+    else
+        beginWindow();
+}
+
+void ScanScheduler::deviceSeen(const QString &address)
+{
+    if (m_inWindow)
+        m_seen.insert(address);
+}
+
+void ScanScheduler::beginWindow()
+{
+    m_inWindow = true;
+    m_seen.clear();
+    m_windowTime.start();
+    m_device->startDeviceDiscovery();
+    m_timer.start(m_currentWindow);
+}
+
+void ScanScheduler::endWindow()
+{
+    m_inWindow = false;
+    m_radioTime += m_windowTime.elapsed();
+    if (m_device->state())
+        m_device->stopDeviceDiscovery();
+
+    adaptWindow();
+
+    if (m_enabled && !m_paused)
+        m_timer.start(qMax(0, m_scanInterval - m_currentWindow));
+    emit statisticsChanged();
+}
+
+void ScanScheduler::adaptWindow()
+{
+    QSet<QString> all = m_previousSeen;
+    all.unite(m_seen);
+    if (!all.isEmpty()) {
+        QSet<QString> common = m_previousSeen;
+        common.intersect(m_seen);
+        m_changeRate = qreal(all.size() - common.size()) / all.size();
+    } else {
+        m_changeRate = 0;
+    }
+    m_previousSeen = m_seen;
+
+    if (!m_adaptive)
+        return;
+
+    // shorten the window while nothing changes, back off quickly otherwise
+    if (m_changeRate < stableChangeRate)
+        m_currentWindow = qMax(m_minScanWindow, m_currentWindow * 3 / 4);
+    else if (m_changeRate > busyChangeRate)
+        m_currentWindow = qMin(m_scanWindow, m_currentWindow * 2);
+}
@@ -0,0 +1,132 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SCANSCHEDULER_H
+#define SCANSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QString>
+
+class Device;
+
+// Runs device discovery in periodic scan windows instead of one long scan.
+// With adaptive mode on, the window shrinks while the set of devices seen
+// stays stable and grows again when it starts changing.
+class ScanScheduler: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(bool adaptive READ isAdaptive WRITE setAdaptive NOTIFY settingsChanged)
+    Q_PROPERTY(int scanWindow READ scanWindow WRITE setScanWindow NOTIFY settingsChanged)
+    Q_PROPERTY(int minScanWindow READ minScanWindow WRITE setMinScanWindow NOTIFY settingsChanged)
+    Q_PROPERTY(int scanInterval READ scanInterval WRITE setScanInterval NOTIFY settingsChanged)
+    Q_PROPERTY(qreal scanCurrent READ scanCurrent WRITE setScanCurrent NOTIFY settingsChanged)
+    Q_PROPERTY(int currentWindow READ currentWindow NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal changeRate READ changeRate NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal dutyCycle READ dutyCycle NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal batteryPerHour READ batteryPerHour NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal cpuPerHour READ cpuPerHour NOTIFY statisticsChanged)
+public:
+    explicit ScanScheduler(Device *device, QObject *parent = 0);
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+    bool isAdaptive() const;
+    void setAdaptive(bool adaptive);
+
+    // while paused no scan windows are opened, e.g. during a fleet audit
+    // which keeps discovery off so its connections are not slowed down
+    void setPaused(bool paused);
+
+    // all durations are in milliseconds
+    int scanWindow() const;
+    void setScanWindow(int window);
+    int minScanWindow() const;
+    void setMinScanWindow(int window);
+    int scanInterval() const;
+    void setScanInterval(int interval);
+
+    // radio current drawn while scanning, in mA, used for the battery estimate
+    qreal scanCurrent() const;
+    void setScanCurrent(qreal current);
+
+    int currentWindow() const;
+    qreal changeRate() const;
+    qreal dutyCycle() const;
+    qreal batteryPerHour() const;
+    qreal cpuPerHour() const;
+
+Q_SIGNALS:
+    void enabledChanged();
+    void settingsChanged();
+    void statisticsChanged();
+
+private slots:
+    void timeout();
+    void deviceSeen(const QString &address);
+
+private:
+    void beginWindow();
+    void endWindow();
+    void adaptWindow();
+
+    Device *m_device;
+    QTimer m_timer;
+    bool m_enabled;
+    bool m_adaptive;
+    bool m_paused;
+    bool m_inWindow;
+    int m_scanWindow;
+    int m_minScanWindow;
+    int m_scanInterval;
+    int m_currentWindow;
+    qreal m_scanCurrent;
+    qreal m_changeRate;
+    QSet<QString> m_seen;
+    QSet<QString> m_previousSeen;
+
+    // cost accounting since the scheduler was enabled
+    QElapsedTimer m_runTime;
+    QElapsedTimer m_windowTime;
+    qint64 m_radioTime;
+    double m_cpuStart;
+};
+
+#endif // SCANSCHEDULER_H
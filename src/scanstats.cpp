@@ -0,0 +1,316 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scanstats.h"
+#include "device.h"
+#include <QDateTime>
+#include <QVariantMap>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// FNV-1a over the address followed by the MurmurHash3 finalizer, the
+// sketches need well mixed high bits
+quint64 hashAddress(const QString &address)
+{
+    quint64 h = Q_UINT64_C(14695981039346656037);
+    const ushort *c = address.utf16();
+    for (int i = 0; i < address.size(); ++i) {
+        h ^= c[i];
+        h *= Q_UINT64_C(1099511628211);
+    }
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+}
+
+bool vendorMoreThan(const QVariant &a, const QVariant &b)
+{
+    return a.toMap().value("count").toInt() > b.toMap().value("count").toInt();
+}
+
+}
+
+ScanStats::ScanStats(Device *device, QObject *parent):
+    QObject(parent), m_device(device), m_second(0), m_vendorMinute(0),
+    m_advertsPerSecond(0), m_advertsInWindow(0), m_uniqueDevices(0)
+{
+    memset(m_adverts, 0, sizeof(m_adverts));
+    memset(m_sketches, 0, sizeof(m_sketches));
+    m_vendors[0].reserve(VendorCounters);
+    m_vendors[1].reserve(VendorCounters);
+    m_strongest.reserve(Strongest);
+
+    m_publishTimer.setInterval(1000);
+    connect(&m_publishTimer, SIGNAL(timeout()), this, SLOT(publish()));
+    connect(m_device, SIGNAL(deviceSeen(QString)), this, SLOT(deviceSeen(QString)));
+}
+
+int ScanStats::windowSeconds() const
+{
+    return Window;
+}
+
+double ScanStats::advertsPerSecond() const
+{
+    return m_advertsPerSecond;
+}
+
+int ScanStats::advertsInWindow() const
+{
+    return m_advertsInWindow;
+}
+
+int ScanStats::uniqueDevices() const
+{
+    return m_uniqueDevices;
+}
+
+QVariantList ScanStats::vendors() const
+{
+    return m_vendorList;
+}
+
+QVariantList ScanStats::strongest() const
+{
+    return m_strongestList;
+}
+
+void ScanStats::deviceSeen(const QString &address)
+{
+    const DeviceInfo *info = m_device->deviceInfo(address);
+    if (info)
+        record(address, info->getName(), info->getVendor(), info->getRssi(),
+               QDateTime::currentMSecsSinceEpoch());
+}
+
+void ScanStats::record(const QString &address, const QString &name, const QString &vendor,
+                       int rssi, qint64 time)
+{
+    const qint64 second = time / 1000;
+    advance(second);
+    const int slot = int(m_second % Window);
+
+    ++m_adverts[slot];
+
+    // the top bits pick the register, the position of the first set bit
+    // of the rest is its rank
+    const quint64 h = hashAddress(address);
+    const int index = int(h >> (64 - SketchBits));
+    quint64 rest = h << SketchBits;
+    quint8 rank = 1;
+    while (rank <= 64 - SketchBits && !(rest & Q_UINT64_C(0x8000000000000000))) {
+        rest <<= 1;
+        ++rank;
+    }
+    if (m_sketches[slot][index] < rank)
+        m_sketches[slot][index] = rank;
+
+    countVendor(vendor.isEmpty() ? QStringLiteral("unknown") : vendor);
+    // 0 means the backend did not report an RSSI
+    if (rssi != 0)
+        updateStrongest(address, name, rssi, m_second);
+
+    if (!m_publishTimer.isActive()) {
+        publish();
+        m_publishTimer.start();
+    }
+}
+
+void ScanStats::advance(qint64 second)
+{
+    // a clock going backwards is counted in the current second
+    if (second <= m_second)
+        return;
+
+    const qint64 first = qMax(m_second + 1, second - Window + 1);
+    for (qint64 s = first; s <= second; ++s) {
+        const int slot = int(s % Window);
+        m_adverts[slot] = 0;
+        memset(m_sketches[slot], 0, Registers);
+    }
+    m_second = second;
+
+    const qint64 minute = second / Window;
+    if (minute != m_vendorMinute) {
+        // after a gap of more than a minute the previous one is empty too
+        if (minute == m_vendorMinute + 1)
+            m_vendors[1] = m_vendors[0];
+        else
+            m_vendors[1].clear();
+        m_vendors[0].clear();
+        m_vendorMinute = minute;
+    }
+}
+
+void ScanStats::countVendor(const QString &vendor)
+{
+    QVector<VendorCounter> &counters = m_vendors[0];
+    int smallest = -1;
+    for (int i = 0; i < counters.size(); ++i) {
+        if (counters[i].vendor == vendor) {
+            ++counters[i].count;
+            return;
+        }
+        if (smallest < 0 || counters[i].count < counters[smallest].count)
+            smallest = i;
+    }
+
+    if (counters.size() < VendorCounters) {
+        VendorCounter counter = { vendor, 1, 0 };
+        counters.append(counter);
+        return;
+    }
+
+    // Space-Saving: the new vendor takes over the smallest counter
+    VendorCounter &evicted = counters[smallest];
+    evicted.vendor = vendor;
+    evicted.error = evicted.count;
+    ++evicted.count;
+}
+
+void ScanStats::updateStrongest(const QString &address, const QString &name, int rssi,
+                                qint64 second)
+{
+    int weakest = -1;
+    for (int i = 0; i < m_strongest.size(); ++i) {
+        StrongDevice &entry = m_strongest[i];
+        if (entry.address == address) {
+            entry.name = name;
+            entry.rssi = rssi;
+            entry.second = second;
+            return;
+        }
+        if (weakest < 0 || entry.rssi < m_strongest[weakest].rssi)
+            weakest = i;
+    }
+
+    StrongDevice entry = { address, name, rssi, second };
+    if (m_strongest.size() < Strongest)
+        m_strongest.append(entry);
+    else if (rssi > m_strongest[weakest].rssi)
+        m_strongest[weakest] = entry;
+}
+
+int ScanStats::estimateUnique() const
+{
+    quint8 merged[Registers];
+    memcpy(merged, m_sketches[0], Registers);
+    for (int slot = 1; slot < Window; ++slot) {
+        for (int i = 0; i < Registers; ++i) {
+            if (merged[i] < m_sketches[slot][i])
+                merged[i] = m_sketches[slot][i];
+        }
+    }
+
+    double sum = 0;
+    int zeros = 0;
+    for (int i = 0; i < Registers; ++i) {
+        sum += std::ldexp(1.0, -merged[i]);
+        if (merged[i] == 0)
+            ++zeros;
+    }
+
+    const double m = Registers;
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    // linear counting is more accurate for small sets
+    if (estimate <= 2.5 * m && zeros > 0)
+        estimate = m * std::log(m / zeros);
+    return qRound(estimate);
+}
+
+void ScanStats::publish()
+{
+    advance(QDateTime::currentMSecsSinceEpoch() / 1000);
+
+    int recent = 0;
+    m_advertsInWindow = 0;
+    for (int age = 0; age < Window; ++age) {
+        const int count = m_adverts[(m_second - age) % Window];
+        m_advertsInWindow += count;
+        if (age < RateWindow)
+            recent += count;
+    }
+    m_advertsPerSecond = double(recent) / RateWindow;
+    m_uniqueDevices = m_advertsInWindow ? estimateUnique() : 0;
+
+    // counters of both minutes added up
+    QVariantMap counts;
+    for (int i = 0; i < 2; ++i) {
+        foreach (const VendorCounter &counter, m_vendors[i])
+            counts[counter.vendor] = counts.value(counter.vendor).toInt() + counter.count;
+    }
+    m_vendorList.clear();
+    for (QVariantMap::const_iterator it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        QVariantMap vendor;
+        vendor["vendor"] = it.key();
+        vendor["count"] = it.value();
+        m_vendorList.append(vendor);
+    }
+    std::sort(m_vendorList.begin(), m_vendorList.end(), vendorMoreThan);
+    while (m_vendorList.size() > TopVendors)
+        m_vendorList.removeLast();
+
+    for (int i = m_strongest.size() - 1; i >= 0; --i) {
+        if (m_second - m_strongest[i].second >= RateWindow)
+            m_strongest.remove(i);
+    }
+    m_strongestList.clear();
+    foreach (const StrongDevice &entry, m_strongest) {
+        QVariantMap device;
+        device["address"] = entry.address;
+        device["name"] = entry.name;
+        device["rssi"] = entry.rssi;
+        int i = 0;
+        while (i < m_strongestList.size()
+               && m_strongestList[i].toMap().value("rssi").toInt() >= entry.rssi)
+            ++i;
+        m_strongestList.insert(i, device);
+    }
+
+    emit updated();
+
+    // nothing left to age out, the next advertisement restarts publishing
+    if (m_advertsInWindow == 0)
+        m_publishTimer.stop();
+}
@@ -0,0 +1,147 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SCANSTATS_H
+#define SCANSTATS_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariant>
+#include <QVector>
+
+class Device;
+
+// Live statistics of the running scan in constant memory, published once
+// a second while advertisements come in:
+//  - advertisements per second over the last ten seconds, from a ring of
+//    per second counters covering the window
+//  - unique devices in the last minute, estimated from a ring of per
+//    second HyperLogLog sketches merged at publish time
+//  - the vendors with the most advertisements, counted with Space-Saving
+//    over the current and the previous minute
+//  - the strongest devices heard in the last ten seconds
+class ScanStats: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int windowSeconds READ windowSeconds CONSTANT)
+    Q_PROPERTY(double advertsPerSecond READ advertsPerSecond NOTIFY updated)
+    Q_PROPERTY(int advertsInWindow READ advertsInWindow NOTIFY updated)
+    Q_PROPERTY(int uniqueDevices READ uniqueDevices NOTIFY updated)
+    Q_PROPERTY(QVariantList vendors READ vendors NOTIFY updated)
+    Q_PROPERTY(QVariantList strongest READ strongest NOTIFY updated)
+public:
+    explicit ScanStats(Device *device, QObject *parent = 0);
+
+    int windowSeconds() const;
+    double advertsPerSecond() const;
+    int advertsInWindow() const;
+    int uniqueDevices() const;
+    // maps with vendor and count, most advertisements first
+    QVariantList vendors() const;
+    // maps with address, name and rssi, strongest first
+    QVariantList strongest() const;
+
+    void record(const QString &address, const QString &name, const QString &vendor,
+                int rssi, qint64 time);
+
+public slots:
+    void publish();
+
+Q_SIGNALS:
+    void updated();
+
+private slots:
+    void deviceSeen(const QString &address);
+
+private:
+    enum {
+        Window = 60,
+        RateWindow = 10,
+        SketchBits = 8,
+        Registers = 1 << SketchBits,
+        VendorCounters = 16,
+        TopVendors = 5,
+        Strongest = 5
+    };
+
+    struct VendorCounter
+    {
+        QString vendor;
+        int count;
+        // overestimate inherited from the evicted counter
+        int error;
+    };
+
+    struct StrongDevice
+    {
+        QString address;
+        QString name;
+        int rssi;
+        qint64 second;
+    };
+
+    void advance(qint64 second);
+    void countVendor(const QString &vendor);
+    void updateStrongest(const QString &address, const QString &name, int rssi,
+                         qint64 second);
+    int estimateUnique() const;
+
+    Device *m_device;
+    QTimer m_publishTimer;
+
+    // slot s % Window holds second s of the last Window seconds up to
+    // m_second, slots of seconds without advertisements are zero
+    qint64 m_second;
+    int m_adverts[Window];
+    quint8 m_sketches[Window][Registers];
+
+    // Space-Saving summaries of the current and the previous minute
+    QVector<VendorCounter> m_vendors[2];
+    qint64 m_vendorMinute;
+
+    QVector<StrongDevice> m_strongest;
+
+    // published values
+    double m_advertsPerSecond;
+    int m_advertsInWindow;
+    int m_uniqueDevices;
+    QVariantList m_vendorList;
+    QVariantList m_strongestList;
+};
+
+#endif // SCANSTATS_H
@@ -42,8 +42,9 @@
 #ifndef SERVICEINFO_H
 #define SERVICEINFO_H
 #include <QtBluetooth/QLowEnergyService>
+#include "instancecounter.h"
 
-class ServiceInfo: public QObject
+class ServiceInfo: public QObject, public InstanceCounted<ServiceInfo>
 {
     Q_OBJECT
     Q_PROPERTY(QString serviceName READ getName NOTIFY serviceChanged)
@@ -0,0 +1,164 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "signalplot.h"
+#include <QSGGeometryNode>
+#include <QSGFlatColorMaterial>
+
+SignalPlot::SignalPlot(QQuickItem *parent):
+    QQuickItem(parent), m_color(QColor("#363636")), m_minimum(0), m_maximum(0)
+{
+    setFlag(ItemHasContents, true);
+}
+
+SampleSeries *SignalPlot::series() const
+{
+    return m_series;
+}
+
+void SignalPlot::setSeries(SampleSeries *series)
+{
+    if (series == m_series)
+        return;
+
+    if (m_series)
+        m_series->disconnect(this);
+    m_series = series;
+    if (m_series)
+        connect(m_series, SIGNAL(samplesChanged()), this, SLOT(samplesChanged()));
+    samplesChanged();
+    emit seriesChanged();
+}
+
+QColor SignalPlot::color() const
+{
+    return m_color;
+}
+
+void SignalPlot::setColor(const QColor &color)
+{
+    m_color = color;
+    update();
+    emit colorChanged();
+}
+
+void SignalPlot::samplesChanged()
+{
+    // both coalesce, so bursts of samples cost one reduction per frame
+    polish();
+    update();
+}
+
+double SignalPlot::minimum() const
+{
+    return m_minimum;
+}
+
+double SignalPlot::maximum() const
+{
+    return m_maximum;
+}
+
+void SignalPlot::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        samplesChanged();
+}
+
+void SignalPlot::updatePolish()
+{
+    const int samples = m_series ? m_series->count() : 0;
+    if (samples < 2 || width() <= 0) {
+        m_bucketMin.clear();
+        m_bucketMax.clear();
+        return;
+    }
+
+    const int columns = qMin(samples, int(width()));
+    m_series->minMax(0, samples, columns, &m_bucketMin, &m_bucketMax);
+
+    double low = m_bucketMin.at(0);
+    double high = m_bucketMax.at(0);
+    for (int i = 1; i < columns; i++) {
+        low = qMin(low, m_bucketMin.at(i));
+        high = qMax(high, m_bucketMax.at(i));
+    }
+    if (low != m_minimum || high != m_maximum) {
+        m_minimum = low;
+        m_maximum = high;
+        emit rangeChanged();
+    }
+}
+
+QSGNode *SignalPlot::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    QSGGeometryNode *node = static_cast<QSGGeometryNode *>(oldNode);
+    if (!node) {
+        node = new QSGGeometryNode;
+        QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(GL_LINE_STRIP);
+        geometry->setLineWidth(2);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGFlatColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+    }
+
+    QSGFlatColorMaterial *material = static_cast<QSGFlatColorMaterial *>(node->material());
+    if (material->color() != m_color) {
+        material->setColor(m_color);
+        node->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    // two vertices per column: down to the bucket minimum and up to its
+    // maximum, which keeps spikes visible however long the history is
+    QSGGeometry *geometry = node->geometry();
+    const int columns = m_bucketMin.size();
+    const double span = m_maximum > m_minimum ? m_maximum - m_minimum : 1;
+    const double scale = (height() - 2) / span;
+    const double step = columns > 1 ? width() / (columns - 1) : 0;
+    geometry->allocate(columns * 2);
+    QSGGeometry::Point2D *vertices = geometry->vertexDataAsPoint2D();
+    for (int i = 0; i < columns; i++) {
+        const float x = float(i * step);
+        vertices[2 * i].set(x, float(height() - 1 - (m_bucketMin.at(i) - m_minimum) * scale));
+        vertices[2 * i + 1].set(x, float(height() - 1 - (m_bucketMax.at(i) - m_minimum) * scale));
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SIGNALPLOT_H
+#define SIGNALPLOT_H
+
+#include <QQuickItem>
+#include <QColor>
+#include <QPointer>
+#include <QVector>
+#include "sampleseries.h"
+
+// Draws a SampleSeries as a single scene graph line strip. The history
+// is reduced to one min/max bucket per pixel column first, so the
+// vertex count depends on the item width only.
+class SignalPlot: public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(SampleSeries *series READ series WRITE setSeries NOTIFY seriesChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(double minimum READ minimum NOTIFY rangeChanged)
+    Q_PROPERTY(double maximum READ maximum NOTIFY rangeChanged)
+public:
+    explicit SignalPlot(QQuickItem *parent = 0);
+
+    SampleSeries *series() const;
+    void setSeries(SampleSeries *series);
+    QColor color() const;
+    void setColor(const QColor &color);
+    double minimum() const;
+    double maximum() const;
+
+Q_SIGNALS:
+    void seriesChanged();
+    void colorChanged();
+    void rangeChanged();
+
+protected:
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
+    void updatePolish();
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *);
+
+private slots:
+    void samplesChanged();
+
+private:
+    QPointer<SampleSeries> m_series;
+    QColor m_color;
+    double m_minimum;
+    double m_maximum;
+    // filled on the GUI thread in updatePolish(), read by the render thread
+    QVector<double> m_bucketMin;
+    QVector<double> m_bucketMax;
+};
+
+#endif // SIGNALPLOT_H
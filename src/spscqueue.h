@@ -0,0 +1,106 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QAtomicInteger>
+#include <QScopedArrayPointer>
+
+// Bounded lock-free queue for exactly one producer thread and one
+// consumer thread. The producer only writes m_head, the consumer only
+// writes m_tail; acquire/release ordering on those two counters is what
+// publishes the slot contents between the threads.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(int capacity)
+    {
+        int size = 1;
+        while (size < capacity)
+            size <<= 1;
+        m_buffer.reset(new T[size]);
+        m_mask = quint32(size - 1);
+    }
+
+    // producer side, returns false and drops the value when full
+    bool push(const T &value)
+    {
+        const quint32 head = m_head.loadAcquire();
+        if (head - m_tail.loadAcquire() > m_mask)
+            return false;
+
+        m_buffer[int(head & m_mask)] = value;
+        m_head.storeRelease(head + 1);
+        return true;
+    }
+
+    // consumer side
+    bool pop(T &value)
+    {
+        const quint32 tail = m_tail.loadAcquire();
+        if (tail == m_head.loadAcquire())
+            return false;
+
+        T &slot = m_buffer[int(tail & m_mask)];
+        value = slot;
+        slot = T();
+        m_tail.storeRelease(tail + 1);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_tail.loadAcquire() == m_head.loadAcquire();
+    }
+
+    int capacity() const
+    {
+        return int(m_mask + 1);
+    }
+
+private:
+    Q_DISABLE_COPY(SpscQueue)
+
+    QScopedArrayPointer<T> m_buffer;
+    quint32 m_mask;
+    QAtomicInteger<quint32> m_head;
+    QAtomicInteger<quint32> m_tail;
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,194 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "streamwriter.h"
+#include <QIODevice>
+#include <qnumeric.h>
+
+CsvWriter::CsvWriter(QIODevice *device):
+    m_stream(device)
+{
+    m_stream.setCodec("UTF-8");
+}
+
+void CsvWriter::writeRow(const QStringList &fields)
+{
+    for (int i = 0; i < fields.size(); i++) {
+        if (i)
+            m_stream << QLatin1Char(',');
+
+        const QString &field = fields.at(i);
+        if (field.contains(QLatin1Char(',')) || field.contains(QLatin1Char('"'))
+                || field.contains(QLatin1Char('\n')) || field.contains(QLatin1Char('\r'))) {
+            QString quoted = field;
+            quoted.replace(QLatin1Char('"'), QStringLiteral("\"\""));
+            m_stream << QLatin1Char('"') << quoted << QLatin1Char('"');
+        } else {
+            m_stream << field;
+        }
+    }
+    m_stream << QLatin1String("\r\n");
+}
+
+bool CsvWriter::hasError() const
+{
+    return m_stream.status() != QTextStream::Ok;
+}
+
+JsonWriter::JsonWriter(QIODevice *device):
+    m_stream(device), m_afterName(false)
+{
+    m_stream.setCodec("UTF-8");
+}
+
+void JsonWriter::beginObject()
+{
+    separate();
+    m_stream << QLatin1Char('{');
+    m_first.append(true);
+}
+
+void JsonWriter::endObject()
+{
+    m_first.removeLast();
+    m_stream << QLatin1Char('}');
+}
+
+void JsonWriter::beginArray()
+{
+    separate();
+    m_stream << QLatin1Char('[');
+    m_first.append(true);
+}
+
+void JsonWriter::endArray()
+{
+    m_first.removeLast();
+    m_stream << QLatin1Char(']');
+}
+
+void JsonWriter::name(const QString &key)
+{
+    separate();
+    writeString(key);
+    m_stream << QLatin1Char(':');
+    m_afterName = true;
+}
+
+void JsonWriter::value(const QString &value)
+{
+    separate();
+    writeString(value);
+}
+
+void JsonWriter::value(qint64 value)
+{
+    separate();
+    m_stream << value;
+}
+
+void JsonWriter::value(double value)
+{
+    separate();
+    if (qIsFinite(value))
+        m_stream << QString::number(value, 'g', 15);
+    else
+        m_stream << QLatin1String("null");
+}
+
+void JsonWriter::value(bool value)
+{
+    separate();
+    m_stream << (value ? QLatin1String("true") : QLatin1String("false"));
+}
+
+void JsonWriter::nullValue()
+{
+    separate();
+    m_stream << QLatin1String("null");
+}
+
+bool JsonWriter::hasError() const
+{
+    return m_stream.status() != QTextStream::Ok;
+}
+
+void JsonWriter::separate()
+{
+    if (m_afterName) {
+        m_afterName = false;
+        return;
+    }
+    if (m_first.isEmpty())
+        return;
+
+    if (m_first.last())
+        m_first.last() = false;
+    else
+        m_stream << QLatin1Char(',');
+}
+
+void JsonWriter::writeString(const QString &str)
+{
+    m_stream << QLatin1Char('"');
+    for (int i = 0; i < str.size(); i++) {
+        const QChar c = str.at(i);
+        switch (c.unicode()) {
+        case '"':
+            m_stream << QLatin1String("\\\"");
+            break;
+        case '\\':
+            m_stream << QLatin1String("\\\\");
+            break;
+        case '\n':
+            m_stream << QLatin1String("\\n");
+            break;
+        case '\r':
+            m_stream << QLatin1String("\\r");
+            break;
+        case '\t':
+            m_stream << QLatin1String("\\t");
+            break;
+        default:
+            if (c.unicode() < 0x20)
+                m_stream << QStringLiteral("\\u%1").arg(c.unicode(), 4, 16, QLatin1Char('0'));
+            else
+                m_stream << c;
+        }
+    }
+    m_stream << QLatin1Char('"');
+}
@@ -0,0 +1,94 @@
+/***************************************************************************
+**
+** This file is part of the BLE scanner application.
+**
+** $QT_BEGIN_LICENSE:BSD$
+** You may use this file under the terms of the BSD license as follows:
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of The Qt Company Ltd nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef STREAMWRITER_H
+#define STREAMWRITER_H
+
+#include <QTextStream>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+
+// Writes CSV rows straight to the output device, one row at a time.
+class CsvWriter
+{
+public:
+    explicit CsvWriter(QIODevice *device);
+
+    void writeRow(const QStringList &fields);
+    bool hasError() const;
+
+private:
+    QTextStream m_stream;
+};
+
+// Writes JSON incrementally instead of building a QJsonDocument first, so
+// the size of an export is not limited by the memory it would take.
+class JsonWriter
+{
+public:
+    explicit JsonWriter(QIODevice *device);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    // sets the key for the next value inside an object
+    void name(const QString &key);
+
+    void value(const QString &value);
+    void value(qint64 value);
+    void value(double value);
+    void value(bool value);
+    void nullValue();
+
+    bool hasError() const;
+
+private:
+    void separate();
+    void writeString(const QString &str);
+
+    QTextStream m_stream;
+    // one entry per open container, true until it received its first element
+    QVector<bool> m_first;
+    bool m_afterName;
+};
+
+#endif // STREAMWRITER_H